@@ -0,0 +1,86 @@
+#include <library/work_contract.h>
+#include <iostream>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+int main()
+{
+    using namespace std::chrono;
+    bcpp::blocking_work_contract_group group;
+    std::jthread worker([&](std::stop_token const & stopToken)
+            {
+                while (!stopToken.stop_requested())
+                    group.execute_next_contract(milliseconds(10));
+            });
+    bcpp::reactor reactor; // or bcpp::reactor(bcpp::reactor::backend::io_uring)
+
+    // a pipe: read until the pipe would block (readiness is edge triggered)
+    int pipeFds[2];
+    ::pipe2(pipeFds, O_NONBLOCK);
+    std::atomic<int> pipeBytes = 0;
+    auto pipeContract = group.create_contract([&]()
+            {
+                char buffer[256];
+                for (auto n = ::read(pipeFds[0], buffer, sizeof(buffer)); n > 0; n = ::read(pipeFds[0], buffer, sizeof(buffer)))
+                    pipeBytes += n;
+            });
+    reactor.add(pipeFds[0], pipeContract);
+
+    // an eventfd: many signals coalesce into a single count (and, usually, a single execution)
+    int eventFd = ::eventfd(0, EFD_NONBLOCK);
+    std::atomic<std::uint64_t> events = 0;
+    auto eventContract = group.create_contract([&]()
+            {
+                if (std::uint64_t count; ::read(eventFd, &count, sizeof(count)) == sizeof(count))
+                    events += count;
+            });
+    reactor.add(eventFd, eventContract);
+
+    // a loopback socket
+    int listener = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addressLength = sizeof(address);
+    ::bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address));
+    ::listen(listener, 1);
+    ::getsockname(listener, reinterpret_cast<sockaddr *>(&address), &addressLength);
+    int client = ::socket(AF_INET, SOCK_STREAM, 0);
+    ::connect(client, reinterpret_cast<sockaddr *>(&address), sizeof(address));
+    int server = ::accept4(listener, nullptr, nullptr, SOCK_NONBLOCK);
+    std::atomic<int> socketBytes = 0;
+    auto socketContract = group.create_contract([&]()
+            {
+                char buffer[256];
+                for (auto n = ::recv(server, buffer, sizeof(buffer), 0); n > 0; n = ::recv(server, buffer, sizeof(buffer), 0))
+                    socketBytes += n;
+            });
+    reactor.add(server, socketContract);
+
+    for (auto i = 0; i < 100; ++i)
+    {
+        std::uint64_t one = 1;
+        [[maybe_unused]] auto _ = ::write(pipeFds[1], "x", 1) + ::write(eventFd, &one, sizeof(one)) + ::send(client, "hello", 5, 0);
+    }
+    std::this_thread::sleep_for(milliseconds(100));
+    std::cout << "Pipe bytes: " << pipeBytes << ", events: " << events << ", socket bytes: " << socketBytes << "\n";
+
+    // remove descriptors from the reactor before closing them
+    reactor.remove(pipeFds[0]);
+    reactor.remove(eventFd);
+    reactor.remove(server);
+    reactor.stop();
+    worker.request_stop();
+    worker.join();
+    for (auto fd : {pipeFds[0], pipeFds[1], eventFd, listener, client, server})
+        ::close(fd);
+    return 0;
+}
@@ -1,8 +1,8 @@
 #include <library/work_contract.h>
-#include <include/spsc_fixed_queue.h>
 #include <iostream>
 #include <thread>
 #include <chrono>
+#include <span>
 
 int main() 
 {
@@ -13,38 +13,36 @@ int main()
                     group.execute_next_contract();
             });
 
-    // Create a lock-free SPSC queue for ingress data (capacity: 10 integers)
-    bcpp::spsc_fixed_queue<int> dataQueue(10);
-
-    auto contract = group.create_contract(
-        [&dataQueue]() mutable 
+    // An ingress contract owns a bounded ring of ingress data (capacity: 16 integers)
+    // and is handed up to 4 items per execution
+    bcpp::ingress_contract<int> ingress(group, {.capacity_ = 16, .maxBatchSize_ = 4},
+        [](std::span<int> values)
         {
-            int value;
-            if (dataQueue.pop(value))
+            for (auto value : values)
             {
                 if (value == -1)
                     bcpp::this_contract::release(); // Release on termination flag
                 else
                     std::cout << "Processed value: " << value << "\n";
             }
-            if (not dataQueue.empty())
-                bcpp::this_contract::schedule(); // Reschedule if more data
         },
         []() { std::cout << "Contract cleanup completed\n"; }
     );
 
-    // Push data to queue and schedule contract
-    for (int i = 1; i <= 5; ++i)
+    // Push data.  Only a push which finds the ring empty schedules the contract
+    // and the contract reschedules itself until the ring is drained.
+    for (int i = 1; i <= 10; ++i)
     {
-        dataQueue.push(i);
-        contract.schedule();
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        while (not ingress.try_push(i))
+            ;
+        if (i % 5 == 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
     }
-    dataQueue.push(-1); // Push termination flag
-    contract.schedule();
+    while (not ingress.try_push(-1)) // Push termination flag
+        ;
 
-    while (contract.is_valid()) {}
+    while (ingress.is_valid()) {}
     worker.request_stop();
     worker.join();
     return 0;
-}
\ No newline at end of file
+}
@@ -51,9 +51,11 @@ namespace example_1
             thread = std::jthread(worker_thread_func);
 
         // create one contract per task and provide the task as the primary work callable to that contract.
+        // char_count_task is too large to be stored inline within the contract so it is explicitly
+        // moved to the heap.
         std::vector<work_contract> contracts;
         for (auto const & path : paths)
-            contracts.push_back(wcg.create_contract(char_count_task(path, target), work_contract::initial_state::scheduled));
+            contracts.push_back(wcg.create_contract(make_heap_callable(char_count_task(path, target)), work_contract::initial_state::scheduled));
 
         // wait for each contract to expire (all files are processed)
         for (auto & contract : contracts)
@@ -83,7 +83,7 @@ namespace example_2
         // deal with 'task' rather than directly with 'work_contract'
         std::vector<task> tasks;
         for (auto const & path : paths)
-            tasks.emplace_back(wcg, char_count_task(path, target));
+            tasks.emplace_back(wcg, make_heap_callable(char_count_task(path, target)));
 
         // wait for each task to complete (all files are processed)
         for (auto & task : tasks)
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "./example_common.h"
+
+#include <thread>
+
+
+namespace example_3
+{
+
+    // example 3:
+    //
+    // char_count_task (used by examples #1 and #2) is written as an explicit state machine
+    // (load, process, done) which reschedules itself after each stage.  The same task can
+    // be written as a coroutine.  Each co_yield reschedules the coroutine's contract 
+    // (this_contract::schedule()) so each stage is still a separate execution of a 
+    // contract, but the state (the stream, buffer and counts) is simply local variables.
+    // The coroutine's frame comes from a recycling pool and nothing is allocated per
+    // suspension.
+
+    using namespace example_common;
+
+
+    //=========================================================================
+    contract_coroutine<std::uint64_t> char_count_coroutine
+    (
+        work_contract_group & wcg,
+        std::filesystem::path path,
+        char target
+    )
+    {
+        // continue as a contract within the group rather than on the creating thread
+        co_await wcg.schedule();
+
+        std::ifstream stream(path, std::ios_base::binary | std::ios_base::in);
+        std::vector<char> buffer(256);
+        std::uint64_t bytesRead = 0;
+        std::uint64_t count = 0;
+        while (true)
+        {
+            // read up to 256 bytes
+            buffer.resize(256);
+            stream.read(buffer.data(), buffer.size());
+            buffer.resize(stream.gcount());
+            bytesRead += buffer.size();
+            if (buffer.empty())
+                break;
+            co_yield {};
+
+            // process the bytes in the buffer
+            for (auto c : buffer)
+                count += (c == target);
+            co_yield {};
+        }
+        std::osyncstream(std::cout) << "Path = " << path << ", bytes read = " << bytesRead << ", count = " << count << "\n";
+        co_return count;
+    }
+
+
+    //=========================================================================
+    void run
+    (
+        std::filesystem::path directory,    // parent directory of files to process
+        char target,                        // letter to count
+        std::uint64_t numThreads            // number of worker threads
+    )
+    {
+        auto paths = load_paths(directory);
+        work_contract_group wcg(paths.size());
+
+        auto worker_thread_func = [&](auto stopToken){while (not stopToken.stop_requested())  wcg.execute_next_contract();};
+        std::vector<std::jthread> threads(numThreads);
+        for (auto & thread : threads)
+            thread = std::jthread(worker_thread_func);
+
+        std::vector<contract_coroutine<std::uint64_t>> coroutines;
+        for (auto const & path : paths)
+            coroutines.push_back(char_count_coroutine(wcg, path, target));
+
+        // wait for each coroutine to complete (all files are processed)
+        std::uint64_t total = 0;
+        for (auto & coroutine : coroutines)
+        {
+            while (!coroutine.is_done())
+                std::this_thread::yield();
+            total += coroutine.get();
+        }
+        std::osyncstream(std::cout) << "Total count = " << total << "\n";
+
+        for (auto & thread : threads)
+        {
+            thread.request_stop();
+            thread.join();
+        }
+    }
+
+}
@@ -1,5 +1,6 @@
 #include "./example_1.h"
 #include "./example_2.h"
+#include "./example_3.h"
 
 
 int main
@@ -17,6 +18,7 @@ int main
     }
     example_1::run(argv[1], argv[2][0], std::atoi(argv[3]));
     example_2::run(argv[1], argv[2][0], std::atoi(argv[3]));
+    example_3::run(argv[1], argv[2][0], std::atoi(argv[3]));
 
     return 0;
 }
\ No newline at end of file
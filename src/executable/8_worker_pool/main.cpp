@@ -0,0 +1,39 @@
+#include <library/work_contract.h>
+#include <iostream>
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+int main()
+{
+    bcpp::blocking_work_contract_group group;
+
+    // one worker per physical core (smt siblings skipped), each pinned to its core
+    bcpp::blocking_worker_pool workerPool(group);
+    std::cout << "worker cpus:";
+    for (auto cpu : workerPool.cpus())
+        std::cout << " " << cpu;
+    std::cout << "\n";
+    workerPool.start();
+
+    std::atomic<int> count = 0;
+    auto contract = group.create_contract([&]()
+            {
+                if (++count < 100)
+                    bcpp::this_contract::schedule();
+                else
+                    bcpp::this_contract::release();
+            },
+            []() { std::cout << "Contract cleanup completed\n"; },
+            bcpp::blocking_work_contract::initial_state::scheduled);
+
+    while (contract.is_valid())
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    std::cout << "Executed " << count << " times with " << workerPool.size() << " workers\n";
+
+    workerPool.resize(1); // surplus workers are stopped and joined
+    std::cout << "Resized to " << workerPool.size() << " worker\n";
+
+    workerPool.stop(); // the group remains usable and the pool can be started again
+    return 0;
+}
@@ -0,0 +1,37 @@
+#include <library/work_contract.h>
+#include <iostream>
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+int main()
+{
+    using namespace std::chrono;
+    bcpp::blocking_work_contract_group group;
+    std::jthread worker([&](std::stop_token const & stopToken)
+            {
+                while (!stopToken.stop_requested())
+                    group.execute_next_contract(milliseconds(10));
+            });
+
+    // a timeout: scheduled once, 50ms from now
+    auto start = steady_clock::now();
+    std::atomic<bool> timedOut = false;
+    auto timeout = group.create_contract([&]()
+            {
+                std::cout << "Timeout after " << duration_cast<milliseconds>(steady_clock::now() - start).count() << "ms\n";
+                timedOut = true;
+            });
+    timeout.schedule_after(milliseconds(50));
+
+    // a heartbeat: scheduled every 10ms (without drift) until released
+    std::atomic<int> beats = 0;
+    auto heartbeat = group.create_contract([&](){ ++beats; });
+    heartbeat.schedule_every(milliseconds(10));
+
+    while (!timedOut)
+        std::this_thread::sleep_for(milliseconds(1));
+    heartbeat.release(); // also stops the periodic schedule
+    std::cout << "Heartbeats: " << beats << "\n";
+    return 0;
+}
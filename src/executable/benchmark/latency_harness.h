@@ -0,0 +1,120 @@
+#pragma once
+
+#include "./test_harness.h"
+
+#include <library/work_contract/latency_histogram.h>
+#include <library/work_contract/time_stamp_counter.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+
+// the histogram of the worker thread which is executing a request
+inline thread_local bcpp::latency_histogram * tlsLatencyHistogram = nullptr;
+
+
+// open loop latency test.  producers issue requests at their intended times without
+// waiting for earlier requests to complete.  each request is a slot which holds the
+// time at which the request was intended to be issued (time stamp counter) and the
+// worker which executes the request records (now - intended time).  measuring from the
+// intended time rather than from when the producer actually issued the request corrects
+// for coordinated omission: a stalled producer (or a producer waiting for a slot to be
+// free) does not hide the delay from the histogram.
+// queues carry the slot index.  work contracts have one contract per slot.
+template <algorithm T>
+class latency_harness : private container<T, void>
+{
+public:
+
+    static auto constexpr is_queue = ((T != algorithm::work_contract) && (T != algorithm::blocking_work_contract) && (T != algorithm::work_contract_batch));
+
+    latency_harness
+    (
+        std::size_t slotCount
+    ):
+        container<T, void>(slotCount),
+        slots_(std::make_unique<slot[]>(slotCount)),
+        slotCount_(slotCount)
+    {
+        if constexpr (!is_queue)
+            for (auto i = 0ull; i < slotCount_; ++i)
+                contracts_.push_back(this->workContractGroup_.create_contract([this, i](){complete(i);}));
+    }
+
+    // producer.  issue the request of the slot.  if the slot's previous request is still
+    // outstanding then wait for it (the wait is included in the request's latency).
+    void issue
+    (
+        std::size_t slotIndex,
+        std::uint64_t intendedTime,
+        std::atomic<bool> const & abort
+    )
+    {
+        auto & slot = slots_[slotIndex];
+        while ((slot.outstanding_.load(std::memory_order_acquire)) && (!abort))
+            ;
+        slot.intendedTime_ = intendedTime;
+        slot.outstanding_.store(true, std::memory_order_release);
+        if constexpr (is_queue)
+            this->push(static_cast<std::int32_t>(slotIndex));
+        else
+            contracts_[slotIndex].schedule();
+    }
+
+    // worker.  execute at most one request (or batch of requests)
+    void process_next_request()
+    {
+        if constexpr (T == algorithm::blocking_work_contract)
+        {
+            // bounded wait so that the worker observes the end of the test
+            this->workContractGroup_.execute_next_contract(std::chrono::milliseconds(1));
+        }
+        else if constexpr (is_queue)
+        {
+            if (std::int32_t slotIndex; this->try_pop(slotIndex))
+                complete(slotIndex);
+        }
+        else
+        {
+            this->execute_next_contract();
+        }
+    }
+
+    bool outstanding() const
+    {
+        for (auto i = 0ull; i < slotCount_; ++i)
+            if (slots_[i].outstanding_.load(std::memory_order_acquire))
+                return true;
+        return false;
+    }
+
+private:
+
+    struct alignas(64) slot
+    {
+        std::uint64_t       intendedTime_{0};
+        std::atomic<bool>   outstanding_{false};
+    };
+
+    void complete
+    (
+        std::size_t slotIndex
+    )
+    {
+        auto & slot = slots_[slotIndex];
+        auto now = bcpp::implementation::read_tsc();
+        tlsLatencyHistogram->record((now > slot.intendedTime_) ? (now - slot.intendedTime_) : 0);
+        slot.outstanding_.store(false, std::memory_order_release);
+    }
+
+    std::unique_ptr<slot[]>                                 slots_;
+
+    std::size_t                                             slotCount_;
+
+    // work contracts only
+    std::vector<std::conditional_t<is_queue, std::size_t, typename container<T, void>::task_type>> contracts_;
+};
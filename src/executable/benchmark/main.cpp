@@ -11,26 +11,34 @@
 #include <cmath>
 #include <iomanip>
 #include <span>
+#include <algorithm>
+#include <string_view>
+#include <cstdio>
 #include <fmt/format.h>
 
 using namespace std::chrono;
 
+// benchmark             throughput: every thread both schedules and executes tasks (closed loop)
+// benchmark latency     schedule to execute latency: dedicated producers issue requests at
+//                       fixed rates (open loop) and workers execute them (see latency_harness.h)
+// benchmark scenarios [producers:consumers[:active] ...]
+//                       throughput with dedicated producer and consumer threads: fan out,
+//                       fan in, balanced and sparse (see test_harness.h) plus any additional
+//                       producer:consumer ratios (and active task counts) given
 
-// it might look a bit odd to hard code the cpus to use in the benchmark
-// but one of my test machines has a blend of different cpus and I can't seem
-// to disable hyperthreading on that machine via the bios nor the terminal.
-// This made ensuring that the benchmark is running on the preferred physical cores 
-// a bit difficult so I just did it this way until I have time to write a tool
-// to dynamically figure out the optimal cores to use.
-//int cores[] = {0,2,4,6,8,10,12,14};
-//int cores[] = {0,2,4,6,8,10,12,14,16,17,18,19,20,21,22,23,24,25,26,27,28,29,30,31};
-int cores[] = {16,17,18,19,20,21,22,23,24,25,26,27,28,29,30,31};
-//int cores[] = {16,20,24,28,17,21,25,29,18,22,26,30,19,23,27,31};
-int mainCpu = 0;
+
+// worker threads are placed one per physical core (smt siblings are skipped) as
+// discovered by bcpp::cpu_topology.  the main thread uses the first physical core 
+// and the workers use the remainder.
+std::vector<std::uint32_t> cores;
+std::uint32_t mainCpu = 0;
 
 static auto constexpr test_duration = 1s;
 static auto constexpr max_tasks = (1 << 13);
-static auto constexpr max_threads = std::extent_v<decltype(cores)>;
+static auto constexpr max_threads = 64;
+static auto constexpr latency_slot_count = max_tasks;
+static auto constexpr latency_drain_timeout = 1s;
+static auto constexpr sparse_active_tasks = (max_tasks / 128);
 
 // containers for gathering stats during test
 std::array<std::atomic<std::size_t>, max_tasks> taskExecutionCount;
@@ -45,6 +53,7 @@ std::atomic<bool> endTest = false;
 std::vector<std::jthread> testThreads;
 
 #include "./test_harness.h"
+#include "./latency_harness.h"
 
 
 //==============================================================================
@@ -129,7 +138,7 @@ auto create_worker_threads
                 (
                 ) mutable
                 {                 
-                    set_cpu_affinity(cores[threadId]);
+                    set_cpu_affinity(cores[threadId % cores.size()]);
                     tlsThreadIndex = threadId; 
                     for (auto & _ : tlsExecutionCount)
                         _ = 0;
@@ -199,6 +208,109 @@ auto test_algorithm
 }
 
 
+//=============================================================================
+struct scenario
+{
+    std::string name_;
+    std::size_t producers_;
+    std::size_t consumers_;
+    std::size_t activeTasks_;
+};
+
+
+//=============================================================================
+template <algorithm T>
+auto test_scenario
+(
+    // the first scenario.producers_ threads produce and the remainder consume
+    scenario const & scenario,
+    std::invocable auto && task
+)
+{
+    test_harness<T, std::decay_t<decltype(task)>> testHarness(max_tasks);
+    for (auto i = 0; i < max_tasks; ++i)
+        testHarness.add_produced_task(task);
+    testHarness.set_producers(scenario.producers_, scenario.activeTasks_);
+
+    create_worker_threads(scenario.producers_ + scenario.consumers_, [&]()
+            {
+                if (tlsThreadIndex < scenario.producers_)
+                    testHarness.produce_tasks(tlsThreadIndex);
+                else
+                    testHarness.consume_next_task();
+            });
+    auto startTime = std::chrono::system_clock::now();
+    startTest = true;
+    std::this_thread::sleep_for(test_duration);
+    endTest = true;
+    auto stopTime = std::chrono::system_clock::now();
+    for (auto & testThread : testThreads)
+        testThread.join();
+
+    // thread cv is across the consumers only
+    auto testDurationInSeconds = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(stopTime - startTime).count() / std::nano::den;
+    auto [taskTotal, taskMean, taskSd, taskCv] = gather_stats(std::span(taskExecutionCount.data(), taskExecutionCount.size()));
+    auto [threadTotal, threadMean, threadSd, threadCv] = gather_stats(std::span(threadExecutionCount.begin() + scenario.producers_, scenario.consumers_));
+    std::cout << fmt::format("{:<12}{:<12}{:<12}{:<10}{:<20}{:<25}{:<10.4f}{:<10.4f}\n", scenario.name_, scenario.producers_, scenario.consumers_, 
+            scenario.activeTasks_, taskTotal, (int)((taskTotal / testDurationInSeconds) / scenario.consumers_), taskCv, 
+            (scenario.consumers_ > 1) ? threadCv : 0.0);
+
+    for (auto & _ : taskExecutionCount)
+        _ = 0;
+    for (auto & _ : threadExecutionCount)
+        _ = 0;
+}
+
+
+//=============================================================================
+auto run_scenario_tests
+(
+    std::size_t maxThreads,
+    std::span<char const *> ratios
+)
+{
+    std::vector<scenario> scenarios
+        {
+            {"fan out", 1, maxThreads - 1, max_tasks},
+            {"fan in", maxThreads - 1, 1, max_tasks},
+            {"balanced", maxThreads / 2, maxThreads - (maxThreads / 2), max_tasks},
+            {"sparse", 1, maxThreads - 1, sparse_active_tasks}
+        };
+    for (auto ratio : ratios)
+    {
+        scenario custom{ratio, 0, 0, max_tasks};
+        if ((std::sscanf(ratio, "%zu:%zu:%zu", &custom.producers_, &custom.consumers_, &custom.activeTasks_) < 2) ||
+                (custom.producers_ == 0) || (custom.consumers_ == 0) || ((custom.producers_ + custom.consumers_) > max_threads))
+        {
+            std::cerr << "invalid scenario " << ratio << " (expected producers:consumers[:active])\n";
+            continue;
+        }
+        custom.activeTasks_ = std::clamp<std::size_t>(custom.activeTasks_, 1, max_tasks);
+        scenarios.push_back(custom);
+    }
+
+    std::string green = "\033[1m";
+    std::string defaultColor = "\033[0m";
+    std::string line = "===========================================================================================================\n";
+    auto header = fmt::format("{:<12}{:<12}{:<12}{:<10}{:<20}{:<25}{:<10}{:<10}\n", "Scenario:", "Producers:", "Consumers:", "Active:", 
+            "Tasks per Second:", "Tasks per Consumer/sec:", "Task cv:", "Consumer cv:");
+
+    auto run = [&]<algorithm T>(std::string title)
+    {
+        std::cout << "\n" << green << line << title << " (dedicated producers and consumers):\n" << header << line << defaultColor;
+        for (auto const & scenario : scenarios)
+            test_scenario<T>(scenario, hash_task<1>);
+    };
+
+    run.template operator()<algorithm::tbb>("TBB concurrent_queue");
+    run.template operator()<algorithm::es>("Strauss MPMC queue");
+    run.template operator()<algorithm::moody_camel>("MoodyCamel ConcurrentQueue");
+    run.template operator()<algorithm::work_contract>("Work Contract");
+    run.template operator()<algorithm::blocking_work_contract>("Blocking Work Contract");
+    run.template operator()<algorithm::work_contract_batch>("Work Contract (batch execution)");
+}
+
+
 //=============================================================================
 auto get_task_duration
 (
@@ -234,16 +346,151 @@ auto get_task_duration
 }
 
 
+//=============================================================================
+template <algorithm T>
+auto test_latency
+(
+    // numProducers threads each issue (requestsPerSecond / numProducers) requests per 
+    // second at evenly spaced intended times for the duration of the test.  the slots 
+    // are divided between the producers.  once the producers stop, the workers continue
+    // until every outstanding request has been executed (or latency_drain_timeout).
+    std::size_t numProducers,
+    std::size_t numWorkers,
+    std::size_t requestsPerSecond
+)
+{
+    latency_harness<T> latencyHarness(latency_slot_count);
+    std::vector<bcpp::latency_histogram> histograms(numWorkers);
+    std::atomic<bool> stopProducers = false;
+    std::atomic<bool> stopWorkers = false;
+    std::atomic<bool> abort = false;
+    std::atomic<std::size_t> readyThreadCount = 0;
+    startTest = false;
+
+    auto ticksPerNanosecond = bcpp::implementation::tsc_ticks_per_nanosecond();
+    auto interval = static_cast<std::uint64_t>((1e9 * numProducers * ticksPerNanosecond) / requestsPerSecond);
+    std::atomic<std::uint64_t> startTime = 0;
+    std::atomic<std::uint64_t> issued = 0;
+
+    std::vector<std::jthread> workers(numWorkers);
+    for (auto i = 0ull; i < numWorkers; ++i)
+        workers[i] = std::jthread([&, i]()
+                {
+                    set_cpu_affinity(cores[(numProducers + i) % cores.size()]);
+                    tlsLatencyHistogram = &histograms[i];
+                    readyThreadCount++;
+                    while (!startTest)
+                        ;
+                    while (!stopWorkers)
+                        latencyHarness.process_next_request();
+                });
+
+    std::vector<std::jthread> producers(numProducers);
+    for (auto i = 0ull; i < numProducers; ++i)
+        producers[i] = std::jthread([&, i]()
+                {
+                    set_cpu_affinity(cores[i % cores.size()]);
+                    auto slotsPerProducer = (latency_slot_count / numProducers);
+                    auto firstSlot = (i * slotsPerProducer);
+                    readyThreadCount++;
+                    while (!startTest)
+                        ;
+                    // producers are offset from one another by a fraction of the interval
+                    auto intendedTime = startTime + ((interval * i) / numProducers);
+                    auto count = 0ull;
+                    for (; !stopProducers; ++count, intendedTime += interval)
+                    {
+                        while ((bcpp::implementation::read_tsc() < intendedTime) && (!stopProducers))
+                            ;
+                        latencyHarness.issue(firstSlot + (count % slotsPerProducer), intendedTime, abort);
+                    }
+                    issued += count;
+                });
+
+    while (readyThreadCount != (numWorkers + numProducers))
+        ;
+    startTime = bcpp::implementation::read_tsc();
+    startTest = true;
+    std::this_thread::sleep_for(test_duration);
+    stopProducers = true;
+    for (auto & producer : producers)
+        producer.join();
+    auto drainDeadline = (std::chrono::steady_clock::now() + latency_drain_timeout);
+    while ((latencyHarness.outstanding()) && (std::chrono::steady_clock::now() < drainDeadline))
+        std::this_thread::yield();
+    abort = true;
+    stopWorkers = true;
+    for (auto & worker : workers)
+        worker.join();
+
+    bcpp::latency_histogram latency;
+    for (auto const & histogram : histograms)
+        latency.merge(histogram);
+    auto testDurationInSeconds = duration_cast<duration<double>>(test_duration).count();
+    std::cout << fmt::format("{:<12}{:<10}{:<14}{:<14}{:<12}{:<12}{:<12}{:<14}{}\n", numProducers, numWorkers, requestsPerSecond, 
+            (std::size_t)(latency.count() / testDurationInSeconds), latency.percentile(0.5).count(), latency.percentile(0.99).count(), 
+            latency.percentile(0.999).count(), latency.max().count(), (latency.count() == issued) ? "" : "(incomplete)");
+}
+
+
+//=============================================================================
+auto run_latency_tests
+(
+    std::size_t maxThreads
+)
+{
+    std::string green = "\033[1m";
+    std::string defaultColor = "\033[0m";
+    std::string line = "========================================================================================================\n";
+    auto header = fmt::format("{:<12}{:<10}{:<14}{:<14}{:<12}{:<12}{:<12}{:<14}\n", "Producers:", "Workers:", "Target/sec:", 
+            "Achieved/sec:", "p50 (ns):", "p99 (ns):", "p99.9 (ns):", "max (ns):");
+
+    auto run = [&]<algorithm T>(std::string title)
+    {
+        std::cout << "\n" << green << line << title << " (schedule to execute latency, open loop):\n" << header << line << defaultColor;
+        for (std::size_t numProducers : {1, 2})
+        {
+            auto numWorkers = (maxThreads > numProducers) ? (maxThreads - numProducers) : 1;
+            for (std::size_t requestsPerSecond : {100'000, 1'000'000, 4'000'000})
+                test_latency<T>(numProducers, numWorkers, requestsPerSecond);
+        }
+    };
+
+    run.template operator()<algorithm::tbb>("TBB concurrent_queue");
+    run.template operator()<algorithm::es>("Strauss MPMC queue");
+    run.template operator()<algorithm::moody_camel>("MoodyCamel ConcurrentQueue");
+    run.template operator()<algorithm::work_contract>("Work Contract");
+    run.template operator()<algorithm::blocking_work_contract>("Blocking Work Contract");
+    run.template operator()<algorithm::work_contract_batch>("Work Contract (batch execution)");
+}
+
+
 //=============================================================================
 int main
 (
-    int, 
-    char const **
+    int argc, 
+    char const ** argv
 )
 {
+    auto physicalCores = bcpp::cpu_topology().physical_cores();
+    mainCpu = physicalCores.front();
+    cores.assign(physicalCores.begin() + (physicalCores.size() > 1), physicalCores.end());
+    auto const maxThreads = std::clamp<std::size_t>(cores.size(), 2, max_threads);
     set_cpu_affinity(mainCpu);
 
-    auto run_test = []<typename T>
+    if ((argc > 1) && (std::string_view(argv[1]) == "latency"))
+    {
+        run_latency_tests(maxThreads);
+        return 0;
+    }
+
+    if ((argc > 1) && (std::string_view(argv[1]) == "scenarios"))
+    {
+        run_scenario_tests(maxThreads, std::span(argv + 2, argc - 2));
+        return 0;
+    }
+
+    auto run_test = [maxThreads]<typename T>
     (
         T task,
         std::string title
@@ -256,24 +503,28 @@ int main
         auto header = fmt::format("{:<15}{:<20}{:<25}{:<10}{:<10}\n", "Thread Count:", "Tasks per Second:", "Tasks per Thread/sec:", "Task cv:", "Thread cv:");
 
         std::cout << "\n" << green << line << "TBB concurrent_queue:\n" << header << line << defaultColor;
-        for (auto i = 2ull; i <= max_threads; ++i)
+        for (auto i = 2ull; i <= maxThreads; ++i)
             test_algorithm<algorithm::tbb>(i, task);
 
         std::cout << "\n" << green << line << "Strauss MPMC queue:\n" << header << line << defaultColor;
-        for (auto i = 2ull; i <= max_threads; ++i)
+        for (auto i = 2ull; i <= maxThreads; ++i)
             test_algorithm<algorithm::es>(i, task);
 
         std::cout << "\n" << green << line << "MoodyCamel ConcurrentQueue:\n" << header << line << defaultColor;
-        for (auto i = 2ull; i <= max_threads; ++i)
+        for (auto i = 2ull; i <= maxThreads; ++i)
             test_algorithm<algorithm::moody_camel>(i, task);
 
         std::cout << "\n" << green << line << "Work Contract:\n" << header << line << defaultColor;
-        for (auto i = 2ull; i <= max_threads; ++i)
+        for (auto i = 2ull; i <= maxThreads; ++i)
             test_algorithm<algorithm::work_contract>(i, task);
 
         std::cout << "\n" << green << line << "Blocking Work Contract:\n" << header << line << defaultColor;
-        for (auto i = 2ull; i <= max_threads; ++i)
+        for (auto i = 2ull; i <= maxThreads; ++i)
             test_algorithm<algorithm::blocking_work_contract>(i, task);
+
+        std::cout << "\n" << green << line << "Work Contract (batch execution):\n" << header << line << defaultColor;
+        for (auto i = 2ull; i <= maxThreads; ++i)
+            test_algorithm<algorithm::work_contract_batch>(i, task);
     };
 
     run_test(hash_task<0>, "maximum contention"); // approx 1.5ns
@@ -5,8 +5,15 @@
 #include <mpmc_queue.h>
 #include <library/work_contract.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <vector>
 
-enum class algorithm {tbb, moody_camel, es, work_contract, blocking_work_contract};
+
+enum class algorithm {tbb, moody_camel, es, work_contract, blocking_work_contract, work_contract_batch};
 
 
 template <algorithm, typename>
@@ -20,6 +27,7 @@ struct container<algorithm::tbb, T>
     container(std::size_t capacity):queue_(){}
     void push(std::int32_t value){queue_.push(value);}
     auto pop(){std::int32_t result; while (!queue_.try_pop(result)); return result;}
+    bool try_pop(std::int32_t & result){return queue_.try_pop(result);}
     tbb::concurrent_queue<std::int32_t> queue_;
 };
 
@@ -31,6 +39,7 @@ struct container<algorithm::moody_camel, T>
     container(std::size_t capacity):queue_(capacity * 2){}
     void push(std::int32_t value){while (!queue_.enqueue(value));}
     auto pop(){std::int32_t result; while (!queue_.try_dequeue(result)); return result;}
+    bool try_pop(std::int32_t & result){return queue_.try_dequeue(result);}
     moodycamel::ConcurrentQueue<std::int32_t> queue_;
 };
 
@@ -42,6 +51,7 @@ struct container<algorithm::es, T>
     container(std::size_t capacity):queue_(capacity * 2){}
     void push(std::int32_t value){while (!queue_.push(value));}
     auto pop(){std::int32_t result; while (!queue_.pop(result)); return result;}
+    bool try_pop(std::int32_t & result){return queue_.pop(result);}
     es::lockfree::mpmc_queue<std::int32_t> queue_;
 };
 
@@ -51,7 +61,7 @@ struct container<algorithm::work_contract, T>
 {
     using task_type = bcpp::work_contract;
     container(std::size_t capacity):workContractGroup_(((capacity * 4)  < 1024) ? 1024 : capacity * 4){}
-    auto create_contract(auto && task){return workContractGroup_.create_contract(task, task_type::initial_state::scheduled);}
+    auto create_contract(auto && task, task_type::initial_state initialState = task_type::initial_state::scheduled){return workContractGroup_.create_contract(task, initialState);}
     auto execute_next_contract(){return workContractGroup_.execute_next_contract();}
     bcpp::work_contract_group workContractGroup_;
 };
@@ -62,19 +72,45 @@ struct container<algorithm::blocking_work_contract, T>
 {
     using task_type = bcpp::blocking_work_contract;
     container(std::size_t capacity):workContractGroup_(((capacity * 4)  < 1024) ? 1024 : capacity * 4){}
-    auto create_contract(auto && task){return workContractGroup_.create_contract(task, task_type::initial_state::scheduled);}
+    auto create_contract(auto && task, task_type::initial_state initialState = task_type::initial_state::scheduled){return workContractGroup_.create_contract(task, initialState);}
     auto execute_next_contract(){return workContractGroup_.execute_next_contract();}
     bcpp::blocking_work_contract_group workContractGroup_;
 };
 
 
 
+template <typename T> 
+struct container<algorithm::work_contract_batch, T>
+{
+    // executes up to batch_size contracts per call rather than one
+    static auto constexpr batch_size = 16;
+    using task_type = bcpp::work_contract;
+    container(std::size_t capacity):workContractGroup_(((capacity * 4)  < 1024) ? 1024 : capacity * 4){}
+    auto create_contract(auto && task, task_type::initial_state initialState = task_type::initial_state::scheduled){return workContractGroup_.create_contract(task, initialState);}
+    auto execute_next_contract(){return workContractGroup_.execute_next_contracts(batch_size);}
+    bcpp::work_contract_group workContractGroup_;
+};
+
+
+// add_task/process_next_task: a closed loop.  every thread is both producer and consumer.
+// each thread executes a task and then reschedules it.
+//
+// add_produced_task/produce_tasks/consume_next_task: dedicated producers and consumers.
+// tasks are scheduled only by producers and are not rescheduled by the consumer which
+// executes them.  the tasks are divided between the producers and each producer keeps
+// at most its share of activeTaskCount tasks scheduled at once.  when activeTaskCount
+// is the number of tasks then every task is rescheduled as soon as it has executed.
+// when it is smaller (sparse) each time an active task executes the producer schedules
+// a randomly chosen task in its place so that only a small fraction of the tasks are
+// scheduled at any time and they are scattered across the whole group.
+// a task is never scheduled again until it has executed so queues hold each task at
+// most once (as work contracts do).
 template <algorithm T, typename T_>
 class test_harness : private container<T, T_>
 {
 public:
 
-    static auto constexpr is_queue = ((T != algorithm::work_contract) && (T != algorithm::blocking_work_contract));
+    static auto constexpr is_queue = ((T != algorithm::work_contract) && (T != algorithm::blocking_work_contract) && (T != algorithm::work_contract_batch));
     using task_type = typename container<T, T_>::task_type;
 
     test_harness(std::size_t capacity) : container<T, T_>(capacity){}
@@ -123,7 +159,128 @@ public:
         }
     }
 
+    void add_produced_task
+    (
+        std::invocable auto && task
+    )
+    {
+        auto taskId = tasks_.size();
+        if constexpr (is_queue)
+        {
+            tasks_.push_back(task);
+        }
+        else
+        {
+            tasks_.push_back(this->create_contract(
+                [this, task, taskId]()
+                {
+                    task();
+                    tlsExecutionCount[taskId]++;
+                    complete(taskId);               // the producer can schedule this task again
+                }, task_type::initial_state::unscheduled));
+        }
+    }
+
+    // call once all tasks have been added and before any producer or consumer runs
+    void set_producers
+    (
+        std::size_t numProducers,
+        std::size_t activeTaskCount
+    )
+    {
+        scheduled_ = std::make_unique<task_state[]>(tasks_.size());
+        producers_ = std::vector<producer>(numProducers);
+        for (auto i = 0ull; i < numProducers; ++i)
+        {
+            auto & producer = producers_[i];
+            producer.firstTask_ = ((tasks_.size() * i) / numProducers);
+            producer.taskCount_ = (((tasks_.size() * (i + 1)) / numProducers) - producer.firstTask_);
+            producer.sparse_ = (activeTaskCount < tasks_.size());
+            producer.random_.seed(i);
+            auto activeCount = std::clamp<std::size_t>(activeTaskCount / numProducers, 1, producer.taskCount_);
+            for (auto j = 0ull; j < activeCount; ++j)
+                producer.active_.push_back(producer.sparse_ ? producer.next_task() : (producer.firstTask_ + j));
+        }
+    }
+
+    // one pass over the producer's active tasks.  schedule each one which has executed
+    // (or a random replacement for it when sparse).
+    void produce_tasks
+    (
+        std::size_t producerIndex
+    )
+    {
+        auto & producer = producers_[producerIndex];
+        for (auto & taskId : producer.active_)
+        {
+            if (scheduled_[taskId].scheduled_.load(std::memory_order_acquire))
+                continue;
+            if (producer.sparse_)
+            {
+                // other active tasks may be (or may have drawn) the replacement
+                if (auto replacement = producer.next_task(); !scheduled_[replacement].scheduled_.load(std::memory_order_acquire))
+                    taskId = replacement;
+            }
+            scheduled_[taskId].scheduled_.store(true, std::memory_order_relaxed);
+            if constexpr (is_queue)
+                this->push(taskId);
+            else
+                tasks_[taskId].schedule();
+        }
+    }
+
+    void consume_next_task()
+    {
+        if constexpr (T == algorithm::blocking_work_contract)
+        {
+            // bounded wait so that the consumer observes the end of the test
+            this->workContractGroup_.execute_next_contract(std::chrono::milliseconds(1));
+        }
+        else if constexpr (is_queue)
+        {
+            if (std::int32_t taskId; this->try_pop(taskId))
+            {
+                tasks_[taskId]();
+                tlsExecutionCount[taskId]++;
+                complete(taskId);
+            }
+        }
+        else
+        {
+            this->execute_next_contract();
+        }
+    }
+
 private:
 
-    std::vector<task_type>  tasks_;
+    struct alignas(64) task_state
+    {
+        std::atomic<bool>   scheduled_{false};
+    };
+
+    struct alignas(64) producer
+    {
+        std::size_t next_task(){return (firstTask_ + (random_() % taskCount_));}
+
+        std::size_t                 firstTask_{0};
+        std::size_t                 taskCount_{0};
+        bool                        sparse_{false};
+        std::minstd_rand            random_;
+        std::vector<std::size_t>    active_;
+    };
+
+    void complete
+    (
+        std::size_t taskId
+    )
+    {
+        scheduled_[taskId].scheduled_.store(false, std::memory_order_release);
+    }
+
+    std::vector<task_type>          tasks_;
+
+    // produced tasks only
+    std::unique_ptr<task_state[]>   scheduled_;
+
+    std::vector<producer>           producers_;
 };
@@ -0,0 +1,316 @@
+#include <cstddef>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdint>
+#include <atomic>
+#include <vector>
+#include <thread>
+#include <string>
+#include <utility>
+#include <algorithm>
+
+#include <concurrentqueue.h>
+#include <library/work_contract.h>
+
+// measures graph throughput (complete runs of a dependency graph per second) for
+// contract_graph against a queue based scheduler in which workers dequeue ready
+// nodes and enqueue the successors whose predecessor counts reach zero.
+//      wide:       one root, wide_graph_width independent nodes, one sink
+//      deep:       a chain of deep_graph_depth nodes
+//      layered:    layered_graph_depth layers of layered_graph_width nodes, each
+//                  depending on two nodes of the previous layer
+// the driving thread runs the graph and waits for it to complete (spinning) and
+// is not one of the worker threads.
+// before measuring, a stress check repeatedly builds a graph, runs it, waits for
+// it and destroys it while workers execute its nodes.  a sink which still uses the
+// graph after wait() returns would be a use after free (run under a sanitizer).
+
+using namespace std::chrono;
+
+static auto constexpr test_duration = 1s;
+static auto constexpr wide_graph_width = 1024u;
+static auto constexpr deep_graph_depth = 1024u;
+static auto constexpr layered_graph_width = 32u;
+static auto constexpr layered_graph_depth = 32u;
+static auto constexpr lifetime_check_runs = 10000u;
+
+
+//==============================================================================
+bool set_cpu_affinity
+(
+    int value
+)
+{
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(value, &cpuSet);
+    return (pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0);
+}
+
+
+//=============================================================================
+// a node's work
+void node_task
+(
+)
+{
+    static thread_local std::uint64_t state = 0;
+    for (auto i = 0; i < 16; ++i)
+        state = (state * 6364136223846793005ull) + 1442695040888963407ull;
+}
+
+
+//=============================================================================
+struct graph_definition
+{
+    std::string                                 name_;
+    std::uint32_t                               nodeCount_;
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> edges_;
+};
+
+
+//=============================================================================
+std::vector<graph_definition> make_graph_definitions
+(
+)
+{
+    std::vector<graph_definition> result;
+
+    graph_definition wide{"wide", wide_graph_width + 2, {}};
+    for (auto i = 1u; i <= wide_graph_width; ++i)
+    {
+        wide.edges_.emplace_back(0, i);
+        wide.edges_.emplace_back(i, wide_graph_width + 1);
+    }
+    result.push_back(std::move(wide));
+
+    graph_definition deep{"deep", deep_graph_depth, {}};
+    for (auto i = 1u; i < deep_graph_depth; ++i)
+        deep.edges_.emplace_back(i - 1, i);
+    result.push_back(std::move(deep));
+
+    graph_definition layered{"layered", layered_graph_width * layered_graph_depth, {}};
+    for (auto layer = 1u; layer < layered_graph_depth; ++layer)
+        for (auto i = 0u; i < layered_graph_width; ++i)
+        {
+            auto to = (layer * layered_graph_width) + i;
+            auto previous = ((layer - 1) * layered_graph_width);
+            layered.edges_.emplace_back(previous + i, to);
+            layered.edges_.emplace_back(previous + ((i + 1) % layered_graph_width), to);
+        }
+    result.push_back(std::move(layered));
+
+    return result;
+}
+
+
+//=============================================================================
+template <typename W>
+std::vector<std::jthread> start_workers
+(
+    std::uint64_t numThreads,
+    std::atomic<bool> const & stop,
+    W worker
+)
+{
+    std::vector<std::jthread> threads(numThreads);
+    auto threadIndex = 0;
+    for (auto & thread : threads)
+        thread = std::jthread([&stop, worker, threadIndex = threadIndex++]() mutable
+                {
+                    set_cpu_affinity((threadIndex + 1) % std::thread::hardware_concurrency());
+                    while (!stop.load(std::memory_order_relaxed))
+                        worker();
+                });
+    return threads;
+}
+
+
+//=============================================================================
+template <typename F>
+double measure
+(
+    // return the number of complete graph runs per second
+    F runOnce
+)
+{
+    set_cpu_affinity(0);
+    std::uint64_t runs = 0;
+    auto start = steady_clock::now();
+    auto end = start + test_duration;
+    while (steady_clock::now() < end)
+    {
+        runOnce();
+        ++runs;
+    }
+    auto seconds = ((double)duration_cast<nanoseconds>(steady_clock::now() - start).count() / std::nano::den);
+    return (runs / seconds);
+}
+
+
+//=============================================================================
+double run_contract_graph_test
+(
+    graph_definition const & definition,
+    std::uint64_t numThreads
+)
+{
+    bcpp::work_contract_group group(definition.nodeCount_);
+    bcpp::contract_graph graph(group);
+    for (auto i = 0u; i < definition.nodeCount_; ++i)
+        graph.add_node(node_task);
+    for (auto [from, to] : definition.edges_)
+        graph.add_edge(from, to);
+
+    std::atomic<bool> stop = false;
+    auto threads = start_workers(numThreads, stop, [&](){group.execute_next_contract();});
+    auto result = measure([&]()
+            {
+                graph.run();
+                while (!graph.is_complete())
+                    ;
+            });
+    stop = true;
+    for (auto & thread : threads)
+        thread.join();
+    return result;
+}
+
+
+//=============================================================================
+double run_queue_test
+(
+    graph_definition const & definition,
+    std::uint64_t numThreads
+)
+{
+    // the same flattened successor lists and cache line padded pending counts
+    // as contract_graph but with ready nodes passed through a concurrent queue
+    struct alignas(64) pending_count
+    {
+        std::atomic<std::uint32_t> value_;
+    };
+
+    auto nodeCount = definition.nodeCount_;
+    std::vector<std::uint32_t> predecessorCount(nodeCount);
+    std::vector<std::uint32_t> firstSuccessor(nodeCount + 1);
+    for (auto [from, to] : definition.edges_)
+    {
+        ++firstSuccessor[from + 1];
+        ++predecessorCount[to];
+    }
+    for (auto i = 0u; i < nodeCount; ++i)
+        firstSuccessor[i + 1] += firstSuccessor[i];
+    std::vector<std::uint32_t> successors(definition.edges_.size());
+    std::vector<std::uint32_t> position(firstSuccessor.begin(), firstSuccessor.end() - 1);
+    for (auto [from, to] : definition.edges_)
+        successors[position[from]++] = to;
+    std::vector<std::uint32_t> roots;
+    std::uint32_t sinkCount = 0;
+    for (auto i = 0u; i < nodeCount; ++i)
+    {
+        if (predecessorCount[i] == 0)
+            roots.push_back(i);
+        sinkCount += (firstSuccessor[i] == firstSuccessor[i + 1]);
+    }
+    std::vector<pending_count> pending(nodeCount);
+    alignas(64) std::atomic<std::uint32_t> remaining = 0;
+    moodycamel::ConcurrentQueue<std::uint32_t> readyQueue(nodeCount);
+
+    std::atomic<bool> stop = false;
+    auto threads = start_workers(numThreads, stop, [&]()
+            {
+                if (std::uint32_t nodeId; readyQueue.try_dequeue(nodeId))
+                {
+                    node_task();
+                    if (firstSuccessor[nodeId] == firstSuccessor[nodeId + 1])
+                        remaining.fetch_sub(1, std::memory_order_acq_rel);
+                    for (auto i = firstSuccessor[nodeId]; i < firstSuccessor[nodeId + 1]; ++i)
+                        if (pending[successors[i]].value_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                            readyQueue.enqueue(successors[i]);
+                }
+            });
+    auto result = measure([&]()
+            {
+                for (auto i = 0u; i < nodeCount; ++i)
+                    pending[i].value_.store(predecessorCount[i], std::memory_order_relaxed);
+                remaining.store(sinkCount, std::memory_order_release);
+                for (auto nodeId : roots)
+                    readyQueue.enqueue(nodeId);
+                while (remaining.load(std::memory_order_acquire) != 0)
+                    ;
+            });
+    stop = true;
+    for (auto & thread : threads)
+        thread.join();
+    return result;
+}
+
+
+//=============================================================================
+bool run_lifetime_check
+(
+    // run, wait for and destroy a wide graph repeatedly.  returns false if any run
+    // did not execute every node exactly once.
+    std::uint64_t numThreads
+)
+{
+    static auto constexpr width = 8u;
+    bcpp::work_contract_group group(width + 2);
+    std::atomic<bool> stop = false;
+    auto threads = start_workers(numThreads, stop, [&](){group.execute_next_contract();});
+
+    auto passed = true;
+    for (auto run = 0u; run < lifetime_check_runs; ++run)
+    {
+        std::atomic<std::uint32_t> executed = 0;
+        {
+            bcpp::contract_graph graph(group);
+            for (auto i = 0u; i < (width + 2); ++i)
+                graph.add_node([&](){executed.fetch_add(1, std::memory_order_relaxed);});
+            for (auto i = 1u; i <= width; ++i)
+            {
+                graph.add_edge(0, i);
+                graph.add_edge(i, width + 1);
+            }
+            graph.run();
+            graph.wait();
+        }
+        passed &= (executed.load() == (width + 2));
+    }
+    stop = true;
+    for (auto & thread : threads)
+        thread.join();
+    return passed;
+}
+
+
+//=============================================================================
+int main
+(
+    int,
+    char const **
+)
+{
+    auto maxThreads = std::max(1u, std::thread::hardware_concurrency() - 1);
+    auto lifetimeCheckPassed = run_lifetime_check(maxThreads);
+    std::cout << "run/wait/destroy check (" << lifetime_check_runs << " runs): " << (lifetimeCheckPassed ? "passed" : "FAILED") << "\n\n";
+    if (!lifetimeCheckPassed)
+        return 1;
+    for (auto const & definition : make_graph_definitions())
+    {
+        std::cout << definition.name_ << " graph: " << definition.nodeCount_ << " nodes, " << definition.edges_.size() << " edges\n";
+        std::cout << std::left << std::setw(15) << "Thread Count:" << std::setw(30) << "contract_graph (runs/sec):"
+                << std::setw(30) << "queue scheduler (runs/sec):" << "Ratio:\n";
+        for (auto numThreads = 1ull; numThreads <= maxThreads; ++numThreads)
+        {
+            auto graph = run_contract_graph_test(definition, numThreads);
+            auto queue = run_queue_test(definition, numThreads);
+            std::cout << std::left << std::setw(15) << numThreads << std::setw(30) << (std::uint64_t)graph
+                    << std::setw(30) << (std::uint64_t)queue << std::fixed << std::setprecision(3) << (graph / queue) << "\n";
+        }
+        std::cout << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,98 @@
+#include <cstddef>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <chrono>
+#include <cstdint>
+#include <atomic>
+#include <vector>
+#include <thread>
+#include <string>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include <library/work_contract.h>
+
+// reports memory per contract (resident set growth while creating contracts) 
+// and single threaded executions per second for contracts created with only a 
+// work function and for contracts created with work, release and exception functions.
+
+using namespace std::chrono;
+
+static auto constexpr contract_count = (1ull << 18);
+static auto constexpr test_duration = 1s;
+
+
+//=============================================================================
+std::uint64_t resident_set_size
+(
+)
+{
+    std::uint64_t pages = 0;
+    std::uint64_t residentPages = 0;
+    std::ifstream("/proc/self/statm") >> pages >> residentPages;
+    return (residentPages * ::sysconf(_SC_PAGESIZE));
+}
+
+
+//=============================================================================
+void run_test
+(
+    // each test is run in a child process so that memory released by a previous
+    // test can not be reused (and therefore hidden from the resident set size).
+    std::string title,
+    auto createContract
+)
+{
+    std::cout << std::flush;
+    if (auto pid = ::fork(); pid != 0)
+    {
+        ::waitpid(pid, nullptr, 0);
+        return;
+    }
+
+    auto rssBefore = resident_set_size();
+    bcpp::work_contract_group group(contract_count);
+    std::vector<bcpp::work_contract> contracts;
+    contracts.reserve(contract_count);
+    auto rssAfterReserve = resident_set_size();
+    for (auto i = 0ull; i < contract_count; ++i)
+        contracts.push_back(createContract(group));
+    auto rssAfterCreate = resident_set_size();
+    auto bytesPerContract = ((double)((rssAfterCreate - rssAfterReserve) + (rssAfterReserve - rssBefore)) / contract_count);
+    // exclude the vector of contract handles held by this test
+    bytesPerContract -= sizeof(bcpp::work_contract);
+
+    auto executed = 0ull;
+    auto start = steady_clock::now();
+    while ((steady_clock::now() - start) < test_duration)
+        executed += group.execute_next_contracts(1024);
+    auto seconds = ((double)duration_cast<nanoseconds>(steady_clock::now() - start).count() / std::nano::den);
+
+    std::cout << std::left << std::setw(30) << title << std::setw(25) << (std::uint64_t)bytesPerContract 
+            << (std::uint64_t)(executed / seconds) << std::endl;
+    contracts.clear();
+    std::exit(0);
+}
+
+
+//=============================================================================
+int main
+(
+    int, 
+    char const **
+)
+{
+    std::cout << "contracts = " << contract_count << "\n";
+    std::cout << std::left << std::setw(30) << "" << std::setw(25) << "Bytes per contract:" << "Executions per second:\n";
+    run_test("work only", [](auto & group)
+            {
+                return group.create_contract([](){bcpp::this_contract::schedule();}, bcpp::work_contract::initial_state::scheduled);
+            });
+    run_test("work, release and exception", [](auto & group)
+            {
+                return group.create_contract([](){bcpp::this_contract::schedule();}, [](){}, [](auto){}, 
+                        bcpp::work_contract::initial_state::scheduled);
+            });
+    return 0;
+}
@@ -0,0 +1,108 @@
+#include <cstddef>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdint>
+#include <atomic>
+#include <vector>
+#include <thread>
+#include <string>
+
+#include <library/work_contract.h>
+
+// compares steady state selection cost of a group which was constructed with its 
+// full capacity up front against a group which started small and grew (by adding 
+// segments) to the same capacity as contracts were created.
+
+using namespace std::chrono;
+
+static auto constexpr test_duration = 1s;
+static auto constexpr contract_count = (1ull << 14);
+static auto constexpr small_initial_capacity = 64;
+
+
+//==============================================================================
+bool set_cpu_affinity
+(
+    int value
+)
+{
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(value, &cpuSet);
+    return (pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0);
+}
+
+
+//=============================================================================
+double run_test
+(
+    // create contract_count self rescheduling contracts in a group of the specified
+    // initial capacity and return the number of contracts executed per second per thread
+    std::uint64_t initialCapacity,
+    std::uint64_t numThreads
+)
+{
+    bcpp::work_contract_group group(initialCapacity);
+    std::vector<bcpp::work_contract> contracts;
+    contracts.reserve(contract_count);
+    for (auto i = 0ull; i < contract_count; ++i)
+        contracts.push_back(group.create_contract([](){bcpp::this_contract::schedule();}, bcpp::work_contract::initial_state::scheduled));
+
+    std::atomic<bool> startTest = false;
+    std::atomic<bool> endTest = false;
+    std::atomic<std::uint64_t> readyCount = 0;
+    std::atomic<std::uint64_t> totalExecuted = 0;
+
+    std::vector<std::jthread> threads(numThreads);
+    auto threadIndex = 0;
+    for (auto & thread : threads)
+        thread = std::jthread([&, threadIndex = threadIndex++]()
+                {
+                    set_cpu_affinity(threadIndex % std::thread::hardware_concurrency());
+                    std::uint64_t executed = 0;
+                    readyCount++;
+                    while (!startTest)
+                        ;
+                    while (!endTest)
+                        executed += (group.execute_next_contract() != ~0ull);
+                    totalExecuted += executed;
+                });
+
+    while (readyCount != numThreads)
+        ;
+    auto start = steady_clock::now();
+    startTest = true;
+    std::this_thread::sleep_for(test_duration);
+    endTest = true;
+    auto elapsed = (steady_clock::now() - start);
+    for (auto & thread : threads)
+        thread.join();
+    contracts.clear();
+
+    auto seconds = ((double)duration_cast<nanoseconds>(elapsed).count() / std::nano::den);
+    return ((totalExecuted / seconds) / numThreads);
+}
+
+
+//=============================================================================
+int main
+(
+    int, 
+    char const **
+)
+{
+    auto maxThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    std::cout << "contracts = " << contract_count << "\n";
+    std::cout << std::left << std::setw(15) << "Thread Count:" << std::setw(35) << "Preallocated (exec/thread/sec):" 
+            << std::setw(35) << "Grown (exec/thread/sec):" << "Ratio:\n";
+    for (auto numThreads = 1ull; numThreads <= maxThreads; ++numThreads)
+    {
+        auto preallocated = run_test(contract_count, numThreads);
+        auto grown = run_test(small_initial_capacity, numThreads);
+        std::cout << std::left << std::setw(15) << numThreads << std::setw(35) << (std::uint64_t)preallocated 
+                << std::setw(35) << (std::uint64_t)grown << std::fixed << std::setprecision(3) << (grown / preallocated) << "\n";
+    }
+    return 0;
+}
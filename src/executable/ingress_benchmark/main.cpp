@@ -0,0 +1,190 @@
+#include <cstddef>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdint>
+#include <atomic>
+#include <vector>
+#include <thread>
+#include <string>
+#include <algorithm>
+
+#include <concurrentqueue.h>
+#include <include/spsc_fixed_queue.h>
+#include <library/work_contract.h>
+
+// measures ingress throughput (items consumed per second by a single worker):
+//      queue + schedule:   the pattern of 6_data_ingress.  the producer pushes to a
+//                          queue and schedules the contract for every item.  the contract
+//                          pops one item per execution and reschedules itself while the
+//                          queue is not empty (spsc_fixed_queue for one producer and
+//                          moodycamel::ConcurrentQueue for several).
+//      ingress_contract:   the producer pushes to the contract's ring (scheduling only on
+//                          the empty to non empty transition) and the contract is handed
+//                          up to max_batch_size items per execution.
+
+using namespace std::chrono;
+
+static auto constexpr test_duration = 1s;
+static auto constexpr queue_capacity = 1024;
+static auto constexpr max_batch_size = 64;
+
+
+//==============================================================================
+bool set_cpu_affinity
+(
+    int value
+)
+{
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(value, &cpuSet);
+    return (pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0);
+}
+
+
+//=============================================================================
+struct result
+{
+    double  itemsPerSecond_;
+    double  executionsPerSecond_;
+};
+
+
+//=============================================================================
+template <typename P>
+result run_test
+(
+    // push is called by each producer until it returns false (full) and then retried.
+    bcpp::work_contract_group & group,
+    std::uint64_t numProducers,
+    P push,
+    std::atomic<std::uint64_t> const & consumed,
+    std::atomic<std::uint64_t> const & executions
+)
+{
+    std::atomic<bool> stop = false;
+    std::jthread worker([&]()
+            {
+                set_cpu_affinity(1 % std::thread::hardware_concurrency());
+                while (!stop)
+                    group.execute_next_contract();
+            });
+    std::vector<std::jthread> producers(numProducers);
+    auto producerIndex = 0;
+    for (auto & producer : producers)
+        producer = std::jthread([&, producerIndex = producerIndex++]()
+                {
+                    set_cpu_affinity((2 + producerIndex) % std::thread::hardware_concurrency());
+                    for (std::uint64_t i = 0; !stop; )
+                        i += push(i);
+                });
+
+    auto start = steady_clock::now();
+    auto startConsumed = consumed.load();
+    auto startExecutions = executions.load();
+    std::this_thread::sleep_for(test_duration);
+    auto elapsed = (steady_clock::now() - start);
+    auto totalConsumed = (consumed - startConsumed);
+    auto totalExecutions = (executions - startExecutions);
+    stop = true;
+    for (auto & producer : producers)
+        producer.join();
+    worker.join();
+
+    auto seconds = ((double)duration_cast<nanoseconds>(elapsed).count() / std::nano::den);
+    return {totalConsumed / seconds, totalExecutions / seconds};
+}
+
+
+//=============================================================================
+result run_queue_test
+(
+    std::uint64_t numProducers
+)
+{
+    bcpp::work_contract_group group(1);
+    std::atomic<std::uint64_t> consumed = 0;
+    std::atomic<std::uint64_t> executions = 0;
+    if (numProducers == 1)
+    {
+        bcpp::spsc_fixed_queue<std::uint64_t> queue(queue_capacity);
+        auto contract = group.create_contract([&]()
+                {
+                    executions.fetch_add(1, std::memory_order_relaxed);
+                    if (std::uint64_t value; queue.pop(value))
+                        consumed.fetch_add(1, std::memory_order_relaxed);
+                    if (!queue.empty())
+                        bcpp::this_contract::schedule();
+                });
+        return run_test(group, numProducers, [&](auto value)
+                {
+                    if (!queue.push(value))
+                        return false;
+                    contract.schedule();
+                    return true;
+                }, consumed, executions);
+    }
+    moodycamel::ConcurrentQueue<std::uint64_t> queue(queue_capacity);
+    auto contract = group.create_contract([&]()
+            {
+                executions.fetch_add(1, std::memory_order_relaxed);
+                if (std::uint64_t value; queue.try_dequeue(value))
+                    consumed.fetch_add(1, std::memory_order_relaxed);
+                if (queue.size_approx() > 0)
+                    bcpp::this_contract::schedule();
+            });
+    return run_test(group, numProducers, [&](auto value)
+            {
+                if (queue.size_approx() >= queue_capacity)
+                    return false;
+                queue.enqueue(value);
+                contract.schedule();
+                return true;
+            }, consumed, executions);
+}
+
+
+//=============================================================================
+template <bcpp::producer_model P>
+result run_ingress_test
+(
+    std::uint64_t numProducers
+)
+{
+    bcpp::work_contract_group group(1);
+    std::atomic<std::uint64_t> consumed = 0;
+    std::atomic<std::uint64_t> executions = 0;
+    bcpp::ingress_contract<std::uint64_t, P> ingress(group, {queue_capacity, max_batch_size}, [&](std::span<std::uint64_t> items)
+            {
+                executions.fetch_add(1, std::memory_order_relaxed);
+                consumed.fetch_add(items.size(), std::memory_order_relaxed);
+            });
+    return run_test(group, numProducers, [&](auto value){return ingress.try_push(value);}, consumed, executions);
+}
+
+
+//=============================================================================
+int main
+(
+    int,
+    char const **
+)
+{
+    std::cout << "queue capacity = " << queue_capacity << ", max batch size = " << max_batch_size << ", one worker\n";
+    std::cout << std::left << std::setw(12) << "Producers:" << std::setw(26) << "queue + schedule:" << std::setw(26) << "ingress_contract:" 
+            << std::setw(10) << "Ratio:" << "(items/sec, items/execution)\n";
+    for (auto numProducers = 1ull; numProducers <= 3; ++numProducers)
+    {
+        auto queue = run_queue_test(numProducers);
+        auto ingress = (numProducers == 1) ? run_ingress_test<bcpp::producer_model::single>(numProducers) :
+                run_ingress_test<bcpp::producer_model::multiple>(numProducers);
+        auto format = [](result const & r)
+                {
+                    return std::to_string((std::uint64_t)r.itemsPerSecond_) + ", " + std::to_string(r.itemsPerSecond_ / std::max(1.0, r.executionsPerSecond_)).substr(0, 5);
+                };
+        std::cout << std::left << std::setw(12) << numProducers << std::setw(26) << format(queue) << std::setw(26) << format(ingress) 
+                << std::fixed << std::setprecision(3) << (ingress.itemsPerSecond_ / queue.itemsPerSecond_) << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,153 @@
+#include <cstddef>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdint>
+#include <atomic>
+#include <vector>
+#include <thread>
+#include <string>
+#include <algorithm>
+#include <fstream>
+
+#include <library/work_contract.h>
+
+// measures the throughput of contracts which reschedule themselves (executions per
+// second) and reports whichever instrumentation the build includes:
+//      WORK_CONTRACT_LATENCY_INSTRUMENTATION:  the schedule to execute latency histogram
+//      WORK_CONTRACT_STATISTICS:               the group's statistics
+//      WORK_CONTRACT_TRACING:                  the trace of the last run with trace_contract_count
+//                                              contracts is written to trace_file_name
+// comparing the throughput of the builds gives the cost of the instrumentation.
+
+using namespace std::chrono;
+
+static auto constexpr test_duration = 1s;
+static auto constexpr trace_contract_count = 16;
+static auto constexpr trace_file_name = "work_contract_trace.json";
+
+
+//==============================================================================
+bool set_cpu_affinity
+(
+    int value
+)
+{
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(value, &cpuSet);
+    return (pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0);
+}
+
+
+//=============================================================================
+void print_schedule_latency
+(
+    // (a template so that get_schedule_latency is only required when instrumentation is enabled)
+    auto & group
+)
+{
+    if constexpr (bcpp::implementation::latency_instrumentation_enabled)
+    {
+        auto latency = group.get_schedule_latency();
+        std::cout << std::setw(10) << latency.percentile(0.5).count() << std::setw(10) << latency.percentile(0.99).count()
+                << std::setw(10) << latency.percentile(0.999).count() << std::setw(12) << latency.max().count() << latency.mean().count();
+    }
+}
+
+
+//=============================================================================
+void print_statistics
+(
+    // (a template so that get_statistics is only required when statistics are enabled)
+    auto & group
+)
+{
+    if constexpr (bcpp::implementation::statistics_enabled)
+    {
+        auto statistics = group.get_statistics();
+        std::cout << std::fixed << std::setprecision(2) << "\n    executions " << statistics.executions_ << ", empty polls " << statistics.emptyPolls_ 
+                << ", schedules " << statistics.scheduleCalls_ << ", signals " << statistics.signalsSet_ << " (coalescing " << statistics.coalescing_ratio() 
+                << "), subtrees/select " << statistics.subtrees_per_select() << ", select retries " << statistics.selectRetries_
+                << ", live " << statistics.liveContracts_ << ", scheduled " << statistics.scheduledContracts_;
+    }
+}
+
+
+//=============================================================================
+void write_trace
+(
+    // (a template so that get_trace is only required when tracing is enabled)
+    auto & group
+)
+{
+    if constexpr (bcpp::implementation::tracing_enabled)
+    {
+        auto trace = group.get_trace();
+        std::ofstream stream(trace_file_name);
+        bcpp::write_chrome_trace(stream, trace);
+        std::cout << "\n    " << trace.size() << " trace events written to " << trace_file_name;
+    }
+}
+
+
+//=============================================================================
+void run_test
+(
+    std::uint64_t numContracts,
+    std::uint64_t numWorkers
+)
+{
+    bcpp::work_contract_group group;
+    std::atomic<std::uint64_t> executions = 0;
+    std::vector<bcpp::work_contract> contracts;
+    for (auto i = 0ull; i < numContracts; ++i)
+        contracts.push_back(group.create_contract([&](){executions.fetch_add(1, std::memory_order_relaxed); bcpp::this_contract::schedule();},
+                bcpp::work_contract::initial_state::scheduled));
+
+    std::atomic<bool> stop = false;
+    std::vector<std::jthread> workers(numWorkers);
+    auto workerIndex = 0;
+    for (auto & worker : workers)
+        worker = std::jthread([&, workerIndex = workerIndex++]()
+                {
+                    set_cpu_affinity(workerIndex % std::thread::hardware_concurrency());
+                    while (!stop)
+                        group.execute_next_contract();
+                });
+    std::this_thread::sleep_for(test_duration);
+    stop = true;
+    for (auto & worker : workers)
+        worker.join();
+
+    std::cout << std::left << std::setw(12) << numContracts << std::setw(10) << numWorkers << std::setw(16)
+            << static_cast<std::uint64_t>(executions / duration_cast<duration<double>>(test_duration).count());
+    print_schedule_latency(group);
+    print_statistics(group);
+    if (numContracts == trace_contract_count)
+        write_trace(group);
+    std::cout << "\n";
+}
+
+
+//=============================================================================
+int main
+(
+    int,
+    char const **
+)
+{
+    std::cout << "latency instrumentation: " << (bcpp::implementation::latency_instrumentation_enabled ? "enabled (latency in ns)" : "disabled") 
+            << ", statistics: " << (bcpp::implementation::statistics_enabled ? "enabled" : "disabled")
+            << ", tracing: " << (bcpp::implementation::tracing_enabled ? "enabled" : "disabled") << "\n";
+    std::cout << std::left << std::setw(12) << "contracts" << std::setw(10) << "workers" << std::setw(16) << "executions/s";
+    if constexpr (bcpp::implementation::latency_instrumentation_enabled)
+        std::cout << std::setw(10) << "p50" << std::setw(10) << "p99" << std::setw(10) << "p99.9" << std::setw(12) << "max" << "mean";
+    std::cout << "\n";
+
+    auto maxWorkers = std::max(1u, std::thread::hardware_concurrency());
+    for (auto numContracts : {1ull, 16ull, 256ull, 4096ull})
+        for (auto numWorkers = 1ull; numWorkers <= maxWorkers; numWorkers *= 2)
+            run_test(numContracts, numWorkers);
+    return 0;
+}
@@ -0,0 +1,193 @@
+#include <cstddef>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdint>
+#include <atomic>
+#include <vector>
+#include <thread>
+#include <string>
+#include <algorithm>
+#include <array>
+#include <memory>
+
+#include <library/work_contract.h>
+
+// compares throughput of workers spread across every numa node executing self
+// rescheduling contracts which touch their own (captured) state.
+//      single group:       one work_contract_group, allocated (and its contracts created)
+//                          on node zero.  workers on other nodes access remote memory.
+//      numa partitioned:   numa_work_contract_group with the contracts spread evenly over
+//                          the nodes.  workers select from their own node's partition first.
+// on a single node system both cases are equivalent.
+
+using namespace std::chrono;
+
+static auto constexpr test_duration = 1s;
+static auto constexpr contracts_per_node = (1ull << 12);
+
+
+//==============================================================================
+bool set_cpu_affinity
+(
+    int value
+)
+{
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(value, &cpuSet);
+    return (pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0);
+}
+
+
+//=============================================================================
+std::vector<std::uint32_t> worker_cpus
+(
+    // one cpu per physical core, interleaved across the numa nodes so that
+    // every node has workers for any thread count greater than the node count
+    bcpp::cpu_topology const & cpuTopology
+)
+{
+    std::vector<std::vector<std::uint32_t>> cpusPerNode;
+    for (auto node = 0u; node < cpuTopology.numa_node_count(); ++node)
+        cpusPerNode.push_back(cpuTopology.cpus(false, node));
+    std::vector<std::uint32_t> result;
+    for (auto i = 0ull; result.size() < cpuTopology.physical_cores().size(); ++i)
+        for (auto const & cpus : cpusPerNode)
+            if (i < cpus.size())
+                result.push_back(cpus[i]);
+    return result;
+}
+
+
+//=============================================================================
+// a contract's work.  the state lives within the contract's (inline) storage
+// and so is on the node where the contract was created.
+struct task
+{
+    std::array<std::uint64_t, 4> state_{};
+
+    void operator()()
+    {
+        for (auto & value : state_)
+            value = (value * 6364136223846793005ull) + 1442695040888963407ull;
+        bcpp::this_contract::schedule();
+    }
+};
+
+
+//=============================================================================
+template <typename G>
+double run_test
+(
+    // return the number of contracts executed per second per thread
+    G & group,
+    std::vector<std::uint32_t> const & cpus,
+    std::uint64_t numThreads
+)
+{
+    std::atomic<bool> startTest = false;
+    std::atomic<bool> endTest = false;
+    std::atomic<std::uint64_t> readyCount = 0;
+    std::atomic<std::uint64_t> totalExecuted = 0;
+
+    std::vector<std::jthread> threads(numThreads);
+    auto threadIndex = 0;
+    for (auto & thread : threads)
+        thread = std::jthread([&, threadIndex = threadIndex++]()
+                {
+                    set_cpu_affinity(cpus[threadIndex % cpus.size()]);
+                    std::uint64_t executed = 0;
+                    readyCount++;
+                    while (!startTest)
+                        ;
+                    while (!endTest)
+                        executed += (group.execute_next_contract() != ~0ull);
+                    totalExecuted += executed;
+                });
+
+    while (readyCount != numThreads)
+        ;
+    auto start = steady_clock::now();
+    startTest = true;
+    std::this_thread::sleep_for(test_duration);
+    endTest = true;
+    auto elapsed = (steady_clock::now() - start);
+    for (auto & thread : threads)
+        thread.join();
+
+    auto seconds = ((double)duration_cast<nanoseconds>(elapsed).count() / std::nano::den);
+    return ((totalExecuted / seconds) / numThreads);
+}
+
+
+//=============================================================================
+double run_single_group_test
+(
+    bcpp::cpu_topology const & cpuTopology,
+    std::vector<std::uint32_t> const & cpus,
+    std::uint64_t numThreads
+)
+{
+    // construct the group and its contracts from node zero
+    auto nodeCount = cpuTopology.numa_node_count();
+    auto totalContracts = (contracts_per_node * nodeCount);
+    std::unique_ptr<bcpp::work_contract_group> group;
+    std::vector<bcpp::work_contract> contracts;
+    std::jthread([&]()
+            {
+                if (auto nodeZeroCpus = cpuTopology.cpus(false, 0); !nodeZeroCpus.empty())
+                    set_cpu_affinity(nodeZeroCpus.front());
+                bcpp::implementation::scoped_numa_memory_policy memoryPolicy(0, nodeCount);
+                group = std::make_unique<bcpp::work_contract_group>(totalContracts);
+                for (auto i = 0ull; i < totalContracts; ++i)
+                    contracts.push_back(group->create_contract(task{}, bcpp::work_contract::initial_state::scheduled));
+            }).join();
+
+    auto result = run_test(*group, cpus, numThreads);
+    contracts.clear();
+    return result;
+}
+
+
+//=============================================================================
+double run_numa_group_test
+(
+    std::vector<std::uint32_t> const & cpus,
+    std::uint64_t numThreads
+)
+{
+    bcpp::numa_work_contract_group group(contracts_per_node);
+    std::vector<bcpp::work_contract> contracts;
+    for (auto node = 0u; node < group.node_count(); ++node)
+        for (auto i = 0ull; i < contracts_per_node; ++i)
+            contracts.push_back(group.create_contract(bcpp::numa_node{node}, task{}, bcpp::work_contract::initial_state::scheduled));
+
+    auto result = run_test(group, cpus, numThreads);
+    contracts.clear();
+    return result;
+}
+
+
+//=============================================================================
+int main
+(
+    int,
+    char const **
+)
+{
+    bcpp::cpu_topology cpuTopology;
+    auto cpus = worker_cpus(cpuTopology);
+
+    std::cout << "numa nodes = " << cpuTopology.numa_node_count() << ", contracts per node = " << contracts_per_node << "\n";
+    std::cout << std::left << std::setw(15) << "Thread Count:" << std::setw(35) << "Single group (exec/thread/sec):"
+            << std::setw(40) << "NUMA partitioned (exec/thread/sec):" << "Ratio:\n";
+    for (auto numThreads = 1ull; numThreads <= cpus.size(); ++numThreads)
+    {
+        auto single = run_single_group_test(cpuTopology, cpus, numThreads);
+        auto partitioned = run_numa_group_test(cpus, numThreads);
+        std::cout << std::left << std::setw(15) << numThreads << std::setw(35) << (std::uint64_t)single
+                << std::setw(40) << (std::uint64_t)partitioned << std::fixed << std::setprecision(3) << (partitioned / single) << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,136 @@
+#include <cstddef>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdint>
+#include <atomic>
+#include <vector>
+#include <thread>
+#include <string>
+#include <algorithm>
+
+#include <library/work_contract.h>
+
+// measures schedule to execute latency of a single urgent contract while the
+// workers are saturated with bulk contracts.  compares the urgent contract sharing
+// a band with the bulk contracts against the urgent contract in a higher priority band.
+
+using namespace std::chrono;
+
+static auto constexpr bulk_contract_count = (1ull << 12);
+static auto constexpr sample_count = 10000;
+static auto constexpr sample_interval = 20us;
+
+
+//==============================================================================
+bool set_cpu_affinity
+(
+    int value
+)
+{
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(value, &cpuSet);
+    return (pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0);
+}
+
+
+//=============================================================================
+template <std::size_t N>
+auto hash_task()
+{
+    static auto constexpr str = "guess what? chicken butt!";
+    auto volatile n = 0;
+    for (auto i = 0ull; i < N; ++i)
+        n *= std::hash<std::string>()(str);
+    return n;
+};
+
+
+//=============================================================================
+void run_test
+(
+    std::string title,
+    bcpp::work_contract_group & group,
+    bcpp::priority_band urgentBand,
+    bcpp::priority_band bulkBand,
+    std::uint64_t numThreads
+)
+{
+    std::vector<bcpp::work_contract> bulkContracts;
+    for (auto i = 0ull; i < bulk_contract_count; ++i)
+        bulkContracts.push_back(group.create_contract(bulkBand, [](){hash_task<8>(); bcpp::this_contract::schedule();}, 
+                bcpp::work_contract::initial_state::scheduled));
+
+    std::atomic<std::int64_t> scheduleTime = 0;
+    std::atomic<bool> executed = true;
+    std::vector<std::int64_t> latency;
+    latency.reserve(sample_count);
+    auto urgentContract = group.create_contract(urgentBand, [&]()
+            {
+                latency.push_back(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count() - scheduleTime);
+                executed = true;
+            });
+
+    std::atomic<bool> endTest = false;
+    std::vector<std::jthread> threads(numThreads);
+    auto threadIndex = 0;
+    for (auto & thread : threads)
+        thread = std::jthread([&, threadIndex = ++threadIndex]()
+                {
+                    set_cpu_affinity(threadIndex % std::thread::hardware_concurrency());
+                    while (!endTest)
+                        group.execute_next_contract();
+                });
+
+    for (auto i = 0; i < sample_count; ++i)
+    {
+        std::this_thread::sleep_for(sample_interval);
+        while (!executed)
+            ;
+        executed = false;
+        scheduleTime = duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+        urgentContract.schedule();
+    }
+    while (!executed)
+        ;
+    endTest = true;
+    for (auto & thread : threads)
+        thread.join();
+    bulkContracts.clear();
+    urgentContract.release();
+
+    std::sort(latency.begin(), latency.end());
+    auto percentile = [&](double p){return latency[std::min<std::size_t>(latency.size() - 1, latency.size() * p)];};
+    std::cout << std::left << std::setw(30) << title << std::setw(12) << percentile(0.5) << std::setw(12) << percentile(0.99) 
+            << std::setw(12) << percentile(0.999) << latency.back() << "\n";
+}
+
+
+//=============================================================================
+int main
+(
+    int, 
+    char const **
+)
+{
+    set_cpu_affinity(0);
+    auto numThreads = std::max(1u, std::thread::hardware_concurrency() - 1);
+
+    std::cout << "worker threads = " << numThreads << ", bulk contracts = " << bulk_contract_count << "\n";
+    std::cout << "urgent contract schedule to execute latency (ns):\n";
+    std::cout << std::left << std::setw(30) << "" << std::setw(12) << "p50" << std::setw(12) << "p99" << std::setw(12) << "p99.9" << "max\n";
+    {
+        bcpp::work_contract_group group(bulk_contract_count * 2);
+        run_test("single band", group, bcpp::priority_band{0}, bcpp::priority_band{0}, numThreads);
+    }
+    {
+        bcpp::work_contract_group group(bulk_contract_count * 2, 2);
+        run_test("strict priority (2 bands)", group, bcpp::priority_band{0}, bcpp::priority_band{1}, numThreads);
+    }
+    {
+        bcpp::work_contract_group group(bulk_contract_count * 2, {4, 1});
+        run_test("weighted 4:1 (2 bands)", group, bcpp::priority_band{0}, bcpp::priority_band{1}, numThreads);
+    }
+    return 0;
+}
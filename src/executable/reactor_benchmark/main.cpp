@@ -0,0 +1,211 @@
+#include <cstddef>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdint>
+#include <atomic>
+#include <vector>
+#include <thread>
+#include <string>
+#include <algorithm>
+
+#include <library/work_contract.h>
+
+#include <unistd.h>
+#include <sys/eventfd.h>
+
+// measures the reactor with each backend (epoll and io_uring):
+//      throughput: producers signal eventfd_count eventfds (each registered against
+//                  a contract which reads its eventfd) as fast as they can.  reports
+//                  signals/sec and contract executions/sec.  signals which arrive while
+//                  a contract is already scheduled coalesce into one execution.
+//      latency:    the time from writing to an eventfd to the execution of its
+//                  contract, with the reactor and worker idle between samples.
+
+using namespace std::chrono;
+
+static auto constexpr test_duration = 1s;
+static auto constexpr eventfd_count = 64;
+static auto constexpr sample_count = 10000;
+static auto constexpr sample_interval = 20us;
+
+
+//==============================================================================
+bool set_cpu_affinity
+(
+    int value
+)
+{
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(value, &cpuSet);
+    return (pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0);
+}
+
+
+//=============================================================================
+std::int64_t now_ns
+(
+)
+{
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+
+//=============================================================================
+std::string backend_name
+(
+    bcpp::reactor::backend backend
+)
+{
+    return (backend == bcpp::reactor::backend::epoll) ? "epoll" : "io_uring";
+}
+
+
+//=============================================================================
+void run_throughput_test
+(
+    bcpp::reactor::backend requestedBackend,
+    std::uint64_t numProducers
+)
+{
+    bcpp::work_contract_group group(eventfd_count);
+    bcpp::reactor reactor(requestedBackend);
+    std::atomic<std::uint64_t> signalsConsumed = 0;
+    std::atomic<std::uint64_t> executions = 0;
+    std::vector<int> eventFds;
+    std::vector<bcpp::work_contract> contracts;
+    for (auto i = 0; i < eventfd_count; ++i)
+    {
+        auto eventFd = eventFds.emplace_back(::eventfd(0, EFD_NONBLOCK));
+        contracts.push_back(group.create_contract([&, eventFd]()
+                {
+                    if (std::uint64_t count; ::read(eventFd, &count, sizeof(count)) == sizeof(count))
+                        signalsConsumed.fetch_add(count, std::memory_order_relaxed);
+                    executions.fetch_add(1, std::memory_order_relaxed);
+                }));
+        reactor.add(eventFd, contracts.back());
+    }
+
+    std::atomic<bool> stop = false;
+    std::jthread worker([&]()
+            {
+                set_cpu_affinity(1 % std::thread::hardware_concurrency());
+                while (!stop)
+                    group.execute_next_contract();
+            });
+    std::atomic<std::uint64_t> signalsSent = 0;
+    std::vector<std::jthread> producers(numProducers);
+    auto producerIndex = 0;
+    for (auto & producer : producers)
+        producer = std::jthread([&, producerIndex = producerIndex++]()
+                {
+                    set_cpu_affinity((2 + producerIndex) % std::thread::hardware_concurrency());
+                    std::uint64_t sent = 0;
+                    std::uint64_t one = 1;
+                    for (auto i = producerIndex; !stop; ++i, ++sent)
+                        [[maybe_unused]] auto _ = ::write(eventFds[i % eventfd_count], &one, sizeof(one));
+                    signalsSent += sent;
+                });
+
+    auto start = steady_clock::now();
+    std::this_thread::sleep_for(test_duration);
+    stop = true;
+    for (auto & producer : producers)
+        producer.join();
+    auto seconds = ((double)duration_cast<nanoseconds>(steady_clock::now() - start).count() / std::nano::den);
+    worker.join();
+    for (auto eventFd : eventFds)
+        reactor.remove(eventFd);
+    reactor.stop();
+
+    std::cout << std::left << std::setw(12) << backend_name(reactor.get_backend()) << std::setw(12) << numProducers 
+            << std::setw(20) << (std::uint64_t)(signalsSent / seconds) << std::setw(20) << (std::uint64_t)(signalsConsumed / seconds) 
+            << std::setw(20) << (std::uint64_t)(executions / seconds) << "\n";
+    contracts.clear();
+    for (auto eventFd : eventFds)
+        ::close(eventFd);
+}
+
+
+//=============================================================================
+void run_latency_test
+(
+    bcpp::reactor::backend requestedBackend
+)
+{
+    bcpp::work_contract_group group(1);
+    bcpp::reactor reactor(requestedBackend);
+    auto eventFd = ::eventfd(0, EFD_NONBLOCK);
+    std::atomic<std::int64_t> writeTime = 0;
+    std::atomic<bool> executed = false;
+    std::vector<std::int64_t> latency;
+    latency.reserve(sample_count);
+    auto contract = group.create_contract([&]()
+            {
+                if (std::uint64_t count; ::read(eventFd, &count, sizeof(count)) == sizeof(count))
+                {
+                    latency.push_back(now_ns() - writeTime.load(std::memory_order_relaxed));
+                    executed.store(true, std::memory_order_release);
+                }
+            });
+    reactor.add(eventFd, contract);
+
+    std::atomic<bool> stop = false;
+    std::jthread worker([&]()
+            {
+                set_cpu_affinity(1 % std::thread::hardware_concurrency());
+                while (!stop)
+                    group.execute_next_contract();
+            });
+
+    set_cpu_affinity(2 % std::thread::hardware_concurrency());
+    std::uint64_t one = 1;
+    for (auto i = 0; i < sample_count; ++i)
+    {
+        executed = false;
+        writeTime.store(now_ns(), std::memory_order_relaxed);
+        [[maybe_unused]] auto _ = ::write(eventFd, &one, sizeof(one));
+        while (!executed.load(std::memory_order_acquire))
+            ;
+        auto until = steady_clock::now() + sample_interval;
+        while (steady_clock::now() < until)
+            ;
+    }
+    stop = true;
+    worker.join();
+    reactor.remove(eventFd);
+    reactor.stop();
+
+    std::sort(latency.begin(), latency.end());
+    auto percentile = [&](double p){return latency[std::min<std::size_t>(latency.size() - 1, latency.size() * p)];};
+    std::cout << std::left << std::setw(12) << backend_name(reactor.get_backend()) << std::setw(10) << percentile(0.5) 
+            << std::setw(10) << percentile(0.99) << std::setw(10) << percentile(0.999) << latency.back() << "\n";
+    contract.release();
+    ::close(eventFd);
+}
+
+
+//=============================================================================
+int main
+(
+    int,
+    char const **
+)
+{
+    auto backends = {bcpp::reactor::backend::epoll, bcpp::reactor::backend::io_uring};
+
+    std::cout << "throughput: " << eventfd_count << " eventfds, one worker\n";
+    std::cout << std::left << std::setw(12) << "Backend:" << std::setw(12) << "Producers:" << std::setw(20) << "Signals/sec:" 
+            << std::setw(20) << "Consumed/sec:" << std::setw(20) << "Executions/sec:" << "\n";
+    for (auto backend : backends)
+        for (auto numProducers = 1ull; numProducers <= 2; ++numProducers)
+            run_throughput_test(backend, numProducers);
+
+    std::cout << "\nwake to execute latency (ns), " << sample_count << " samples\n";
+    std::cout << std::left << std::setw(12) << "Backend:" << std::setw(10) << "p50:" << std::setw(10) << "p99:" 
+            << std::setw(10) << "p99.9:" << "max:\n";
+    for (auto backend : backends)
+        run_latency_test(backend);
+    return 0;
+}
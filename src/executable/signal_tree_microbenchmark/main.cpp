@@ -0,0 +1,286 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <include/signal_tree.h>
+
+
+// google benchmark microbenchmarks of the signal tree in isolation (no work contract
+// group).  every benchmark is registered for each valid signal tree capacity (see
+// select_tree_size) so that the cost of each additional tree level is visible.
+//
+// set              : set a batch of signals scattered across the tree
+// select           : select (and clear) a batch of signals scattered across the tree
+// empty_select     : select on an empty tree (the cost of an unsuccessful poll)
+// set_select       : select a signal and set it again on a tree which holds a batch of
+//                    signals.  once with each selector.
+// contended        : set and select from 1 to hardware_concurrency threads sharing a tree
+//
+// each result includes the tree's level count and the time per operation per level
+// (time_per_level) as the per level breakdown.
+
+
+namespace
+{
+
+    // the valid signal tree capacities (64 to 2^27)
+    static std::array<std::uint64_t, 16> constexpr capacities
+        {
+            64,
+            64 << 3,
+            64 << 5,
+            64 << 7,
+            64 << 9,
+            64 << 11,
+            64 << 12,
+            64 << 13,
+            64 << 14,
+            64 << 15,
+            64 << 16,
+            64 << 17,
+            64 << 18,
+            64 << 19,
+            64 << 20,
+            64 << 21
+        };
+
+    static auto constexpr max_batch_size = 1024ull;
+
+    using namespace bcpp::implementation::signal_tree;
+    using bcpp::signal_index;
+    using bcpp::invalid_signal_index;
+
+
+    //=========================================================================
+    // distinct signal indices spread across the whole tree (one per stride) in random order
+    std::vector<signal_index> make_batch
+    (
+        std::uint64_t capacity,
+        std::uint64_t seed
+    )
+    {
+        auto batchSize = std::min<std::uint64_t>(capacity, max_batch_size);
+        auto stride = (capacity / batchSize);
+        std::mt19937_64 random(seed);
+        std::vector<signal_index> batch(batchSize);
+        for (auto i = 0ull; i < batchSize; ++i)
+            batch[i] = ((i * stride) + (random() % stride));
+        std::shuffle(batch.begin(), batch.end(), random);
+        return batch;
+    }
+
+
+    //=========================================================================
+    std::vector<std::uint64_t> make_biases
+    (
+        std::uint64_t seed
+    )
+    {
+        std::mt19937_64 random(seed);
+        std::vector<std::uint64_t> biases(max_batch_size);
+        for (auto & bias : biases)
+            bias = random();
+        return biases;
+    }
+
+
+    //=========================================================================
+    template <typename T>
+    void add_counters
+    (
+        benchmark::State & state,
+        std::uint64_t operations
+    )
+    {
+        state.SetItemsProcessed(operations);
+        state.counters["levels"] = T::level_count;
+        // the inverse of the rate of level operations (reported as a time)
+        state.counters["time_per_level"] = benchmark::Counter(static_cast<double>(operations * T::level_count),
+                benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+    }
+
+
+    //=========================================================================
+    template <std::uint64_t N>
+    void set_benchmark
+    (
+        benchmark::State & state
+    )
+    {
+        using tree_type = tree<N>;
+        auto signalTree = std::make_unique<tree_type>();
+        auto batch = make_batch(N, N);
+        auto operations = 0ull;
+
+        for (auto _ : state)
+        {
+            auto start = std::chrono::steady_clock::now();
+            for (auto signalIndex : batch)
+                benchmark::DoNotOptimize(signalTree->set(signalIndex));
+            auto stop = std::chrono::steady_clock::now();
+            state.SetIterationTime(std::chrono::duration<double>(stop - start).count());
+            operations += batch.size();
+
+            // untimed: empty the tree for the next iteration
+            while (!signalTree->empty())
+                signalTree->select(0);
+        }
+        add_counters<tree_type>(state, operations);
+    }
+
+
+    //=========================================================================
+    template <std::uint64_t N>
+    void select_benchmark
+    (
+        benchmark::State & state
+    )
+    {
+        using tree_type = tree<N>;
+        auto signalTree = std::make_unique<tree_type>();
+        auto batch = make_batch(N, N);
+        auto biases = make_biases(N);
+        auto operations = 0ull;
+
+        for (auto _ : state)
+        {
+            // untimed: fill the tree
+            for (auto signalIndex : batch)
+                signalTree->set(signalIndex);
+
+            auto start = std::chrono::steady_clock::now();
+            for (auto i = 0ull; i < batch.size(); ++i)
+                benchmark::DoNotOptimize(signalTree->select(biases[i]));
+            auto stop = std::chrono::steady_clock::now();
+            state.SetIterationTime(std::chrono::duration<double>(stop - start).count());
+            operations += batch.size();
+        }
+        add_counters<tree_type>(state, operations);
+    }
+
+
+    //=========================================================================
+    template <std::uint64_t N>
+    void empty_select_benchmark
+    (
+        benchmark::State & state
+    )
+    {
+        using tree_type = tree<N>;
+        auto signalTree = std::make_unique<tree_type>();
+        auto bias = 0ull;
+
+        for (auto _ : state)
+            benchmark::DoNotOptimize(signalTree->select(bias++));
+        add_counters<tree_type>(state, state.iterations());
+    }
+
+
+    //=========================================================================
+    template <std::uint64_t N, template <std::uint64_t, std::uint64_t> class selector>
+    void set_select_benchmark
+    (
+        benchmark::State & state
+    )
+    {
+        using tree_type = tree<N>;
+        auto signalTree = std::make_unique<tree_type>();
+        for (auto signalIndex : make_batch(N, N))
+            signalTree->set(signalIndex);
+        auto biases = make_biases(N);
+        auto i = 0ull;
+
+        for (auto _ : state)
+        {
+            auto [signalIndex, unused] = signalTree->template select<selector>(biases[i++ % biases.size()]);
+            benchmark::DoNotOptimize(signalTree->set(signalIndex));
+        }
+        add_counters<tree_type>(state, state.iterations() * 2);
+    }
+
+
+    //=========================================================================
+    template <std::uint64_t N>
+    void contended_benchmark
+    (
+        // each thread sets a signal from its own batch and then selects any signal
+        benchmark::State & state
+    )
+    {
+        using tree_type = tree<N>;
+        static std::unique_ptr<tree_type> signalTree;
+        if (state.thread_index() == 0)
+            signalTree = std::make_unique<tree_type>();
+        auto batch = make_batch(N, N + state.thread_index());
+        auto biases = make_biases(N + state.thread_index());
+        auto operations = 0ull;
+        auto i = 0ull;
+
+        // the framework synchronizes the threads before and after the timed loop
+        for (auto _ : state)
+        {
+            operations += signalTree->set(batch[i % batch.size()]).second;
+            operations += (signalTree->select(biases[i % biases.size()]).first != invalid_signal_index);
+            ++i;
+        }
+        add_counters<tree_type>(state, operations);
+
+        if (state.thread_index() == 0)
+            signalTree.reset();
+    }
+
+
+    //=========================================================================
+    template <std::uint64_t N>
+    void register_benchmarks()
+    {
+        auto const suffix = ("/" + std::to_string(N));
+        auto const maxThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+        benchmark::RegisterBenchmark(("set" + suffix).c_str(), set_benchmark<N>)->UseManualTime();
+        benchmark::RegisterBenchmark(("select" + suffix).c_str(), select_benchmark<N>)->UseManualTime();
+        benchmark::RegisterBenchmark(("empty_select" + suffix).c_str(), empty_select_benchmark<N>);
+        benchmark::RegisterBenchmark(("set_select/default_selector" + suffix).c_str(), set_select_benchmark<N, default_selector>);
+        benchmark::RegisterBenchmark(("set_select/largest_child_selector" + suffix).c_str(), set_select_benchmark<N, largest_child_selector>);
+        benchmark::RegisterBenchmark(("contended" + suffix).c_str(), contended_benchmark<N>)->ThreadRange(1, maxThreads)->UseRealTime();
+    }
+
+
+    //=========================================================================
+    template <std::size_t ... I>
+    void register_all_benchmarks
+    (
+        std::index_sequence<I ...>
+    )
+    {
+        (register_benchmarks<capacities[I]>(), ...);
+    }
+
+} // namespace
+
+
+//=============================================================================
+int main
+(
+    int argc,
+    char ** argv
+)
+{
+    register_all_benchmarks(std::make_index_sequence<capacities.size()>());
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
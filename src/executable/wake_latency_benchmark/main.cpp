@@ -0,0 +1,278 @@
+#include <cstddef>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdint>
+#include <atomic>
+#include <vector>
+#include <thread>
+#include <string>
+#include <algorithm>
+#include <mutex>
+#include <condition_variable>
+
+#include <library/work_contract.h>
+
+#include <sys/resource.h>
+
+// measures the latency from scheduling a contract to its execution when the group
+// is idle between samples, the cost of the schedule call itself and the cpu consumed
+// (process cpu time / wall time) while doing so.  compares:
+//      non blocking:       workers spin continuously
+//      blocking:           workers park on a futex immediately when idle
+//      hybrid:             workers spin (adaptively) for up to 50us and then park
+//      condition variable: workers park on a mutex and condition variable (notify_all 
+//                          on the transition to non empty) as blocking groups did previously.
+// with the short interval between samples the hybrid workers are still spinning when
+// the contract is scheduled.  with the long interval they have parked.
+
+using namespace std::chrono;
+
+static auto constexpr sample_count = 10000;
+static auto constexpr short_sample_interval = 20us;
+static auto constexpr long_sample_interval = 500us;
+
+
+//==============================================================================
+bool set_cpu_affinity
+(
+    int value
+)
+{
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(value, &cpuSet);
+    return (pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0);
+}
+
+
+//=============================================================================
+std::int64_t now_ns
+(
+)
+{
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+
+//=============================================================================
+std::int64_t cpu_time_ns
+(
+)
+{
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return ((usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1'000'000'000ll) + ((usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1'000ll);
+}
+
+
+//=============================================================================
+// parks workers of a non blocking group on a condition variable.  mirrors the
+// previous blocking mode: the scheduler takes the mutex and wakes every worker
+// when the count of pending contracts goes from zero to non zero.
+struct condition_variable_parking
+{
+    std::mutex              mutex_;
+    std::condition_variable conditionVariable_;
+    std::atomic<std::int64_t> pendingCount_{0};
+    std::atomic<bool>       stopped_{false};
+
+    void schedule(bcpp::work_contract & workContract)
+    {
+        workContract.schedule();
+        if (pendingCount_++ == 0)
+        {
+            std::lock_guard lockGuard(mutex_);
+            conditionVariable_.notify_all();
+        }
+    }
+
+    bool wait()
+    {
+        if (pendingCount_ == 0)
+        {
+            std::unique_lock uniqueLock(mutex_);
+            conditionVariable_.wait(uniqueLock, [this](){return ((pendingCount_ != 0) || (stopped_));});
+        }
+        return (not stopped_);
+    }
+
+    void stop()
+    {
+        stopped_ = true;
+        std::lock_guard lockGuard(mutex_);
+        conditionVariable_.notify_all();
+    }
+};
+
+
+//=============================================================================
+struct result
+{
+    std::vector<std::int64_t>   latency_;
+    std::int64_t                totalScheduleTime_{0};
+    std::int64_t                cpuTime_{0};
+    std::int64_t                wallTime_{0};
+};
+
+
+//=============================================================================
+void print_result
+(
+    std::string title,
+    result & result
+)
+{
+    auto & latency = result.latency_;
+    std::sort(latency.begin(), latency.end());
+    auto percentile = [&](double p){return latency[std::min<std::size_t>(latency.size() - 1, latency.size() * p)];};
+    std::cout << std::left << std::setw(26) << title << std::setw(10) << percentile(0.5) << std::setw(10) << percentile(0.99)
+            << std::setw(10) << percentile(0.999) << std::setw(12) << latency.back() << std::setw(18) << (result.totalScheduleTime_ / sample_count) 
+            << std::fixed << std::setprecision(1) << (100.0 * result.cpuTime_ / result.wallTime_) << "\n";
+}
+
+
+//=============================================================================
+template <typename F>
+void sample
+(
+    // schedule the contract sample_count times with the specified interval between 
+    // samples.  records the time spent in schedule() and the cpu consumed.
+    F && schedule,
+    std::atomic<bool> & executed,
+    microseconds sampleInterval,
+    result & result
+)
+{
+    auto startCpuTime = cpu_time_ns();
+    auto startWallTime = now_ns();
+    for (auto i = 0; i < sample_count; ++i)
+    {
+        std::this_thread::sleep_for(sampleInterval);
+        while (!executed)
+            ;
+        executed = false;
+        auto start = now_ns();
+        schedule(start);
+        result.totalScheduleTime_ += (now_ns() - start);
+    }
+    while (!executed)
+        ;
+    result.cpuTime_ = (cpu_time_ns() - startCpuTime);
+    result.wallTime_ = (now_ns() - startWallTime);
+}
+
+
+//=============================================================================
+template <typename G>
+void run_group_test
+(
+    std::string title,
+    G & group,
+    std::uint64_t numThreads,
+    microseconds sampleInterval
+)
+{
+    std::atomic<bool> endTest = false;
+    std::atomic<std::int64_t> scheduleTime = 0;
+    std::atomic<bool> executed = true;
+    result result;
+    result.latency_.reserve(sample_count);
+    auto workContract = group.create_contract([&]()
+            {
+                result.latency_.push_back(now_ns() - scheduleTime);
+                executed = true;
+            });
+
+    std::vector<std::jthread> threads(numThreads);
+    auto threadIndex = 0;
+    for (auto & thread : threads)
+        thread = std::jthread([&, threadIndex = ++threadIndex]()
+                {
+                    set_cpu_affinity(threadIndex % std::thread::hardware_concurrency());
+                    while (!endTest)
+                        group.execute_next_contract();
+                });
+
+    sample([&](auto start){scheduleTime = start; workContract.schedule();}, executed, sampleInterval, result);
+    endTest = true;
+    group.stop();
+    for (auto & thread : threads)
+        thread.join();
+    print_result(title, result);
+}
+
+
+//=============================================================================
+void run_condition_variable_test
+(
+    std::uint64_t numThreads,
+    microseconds sampleInterval
+)
+{
+    bcpp::work_contract_group group(64);
+    condition_variable_parking parking;
+    std::atomic<std::int64_t> scheduleTime = 0;
+    std::atomic<bool> executed = true;
+    result result;
+    result.latency_.reserve(sample_count);
+    auto workContract = group.create_contract([&]()
+            {
+                --parking.pendingCount_;
+                result.latency_.push_back(now_ns() - scheduleTime);
+                executed = true;
+            });
+
+    std::vector<std::jthread> threads(numThreads);
+    auto threadIndex = 0;
+    for (auto & thread : threads)
+        thread = std::jthread([&, threadIndex = ++threadIndex]()
+                {
+                    set_cpu_affinity(threadIndex % std::thread::hardware_concurrency());
+                    while (parking.wait())
+                        group.execute_next_contract();
+                });
+
+    sample([&](auto start){scheduleTime = start; parking.schedule(workContract);}, executed, sampleInterval, result);
+    parking.stop();
+    for (auto & thread : threads)
+        thread.join();
+    print_result("condition variable", result);
+}
+
+
+//=============================================================================
+int main
+(
+    int,
+    char const **
+)
+{
+    set_cpu_affinity(0);
+    auto maxThreads = std::max(1u, std::thread::hardware_concurrency() - 1);
+
+    std::cout << "schedule to execute latency (ns), schedule() cost (ns) and process cpu utilization:\n";
+    for (auto sampleInterval : {short_sample_interval, long_sample_interval})
+    {
+        for (auto numThreads = 1ull; numThreads <= maxThreads; numThreads *= 2)
+        {
+            std::cout << "\nworker threads = " << numThreads << ", interval between samples = " << sampleInterval.count() << "us\n";
+            std::cout << std::left << std::setw(26) << "" << std::setw(10) << "p50" << std::setw(10) << "p99" << std::setw(10) << "p99.9"
+                    << std::setw(12) << "max" << std::setw(18) << "schedule()" << "cpu (%)\n";
+            {
+                bcpp::work_contract_group group(64);
+                run_group_test("non blocking", group, numThreads, sampleInterval);
+            }
+            {
+                bcpp::blocking_work_contract_group group(64);
+                run_group_test("blocking (futex)", group, numThreads, sampleInterval);
+            }
+            {
+                bcpp::hybrid_work_contract_group group(64);
+                run_group_test("hybrid (spin then park)", group, numThreads, sampleInterval);
+            }
+            run_condition_variable_test(numThreads, sampleInterval);
+        }
+    }
+    return 0;
+}
@@ -53,6 +53,15 @@ namespace bcpp::implementation::signal_tree
         using child_level_type = child_level<T>::type;
         using bias_flags = std::uint64_t;
         using node_index = std::uint64_t;
+
+        // the number of levels from this level down to (and including) the leaf level
+        static auto constexpr level_count = []()
+                {
+                    if constexpr (leaf_level_traits<T>)
+                        return 1ull;
+                    else
+                        return (child_level_type::level_count + 1);
+                }();
         
         bool empty() const noexcept requires (root_level_traits<T>);
 
@@ -61,10 +70,17 @@ namespace bcpp::implementation::signal_tree
             signal_index
         ) noexcept;
 
-        template <template <std::uint64_t, std::uint64_t> class>
+        std::pair<bool, std::uint64_t> set_bits
+        (
+            signal_index,
+            std::uint64_t
+        ) noexcept;
+
+        template <template <std::uint64_t, std::uint64_t> class, typename retry_function>
         std::pair<signal_index, bool> select
         (
-            bias_flags
+            bias_flags,
+            retry_function
         ) noexcept requires (root_level_traits<T>);
 
     protected:
@@ -77,11 +93,12 @@ namespace bcpp::implementation::signal_tree
 
         template <level_traits_concept> friend struct level;
 
-        template <template <std::uint64_t, std::uint64_t> class>
+        template <template <std::uint64_t, std::uint64_t> class, typename retry_function>
         std::pair<signal_index, bool> select
         (
             bias_flags,
-            node_index
+            node_index,
+            retry_function
         ) noexcept;
 
         using node_array = std::array<node_type, node_count>;
@@ -127,33 +144,62 @@ inline std::pair<bool, bool> bcpp::implementation::signal_tree::level<T>::set
 
 //=============================================================================
 template <bcpp::implementation::signal_tree::level_traits_concept T>
-template <template <std::uint64_t, std::uint64_t> class select_function>
+inline std::pair<bool, std::uint64_t> bcpp::implementation::signal_tree::level<T>::set_bits
+(
+    // set several signals which share the same leaf node.  signalIndex is the index of
+    // the first signal of that leaf node and bits are the leaf bits to set (msb first).
+    // the leaf is updated with one fetch_or and each parent counter with one fetch_add
+    // of the number of signals which were not already set.
+    // returns true if the level moved from empty to non empty and the number of newly set signals.
+    signal_index signalIndex,
+    std::uint64_t bits
+) noexcept
+{
+    if constexpr (non_leaf_level_traits<T>)
+    {
+        auto [_, count] = childLevel_.set_bits(signalIndex, bits);
+        if (count == 0)
+            return {false, 0};
+        return nodes_[signalIndex / node_capacity].add(signalIndex % node_capacity, count);
+    }
+    else
+    {
+        return nodes_[signalIndex / node_capacity].set_bits(bits);
+    }
+}
+
+
+//=============================================================================
+template <bcpp::implementation::signal_tree::level_traits_concept T>
+template <template <std::uint64_t, std::uint64_t> class select_function, typename retry_function>
 inline auto bcpp::implementation::signal_tree::level<T>::select
 (
     // return the index of a counter which is not zero (indicates that one of the leaf nodes
     // represented by this counter is set - a non zero value)
-    bias_flags biasFlags
+    bias_flags biasFlags,
+    retry_function onRetry
 ) noexcept -> std::pair<signal_index, bool>
 requires (root_level_traits<T>)
 {
-    return select<select_function>(biasFlags, 0);
+    return select<select_function>(biasFlags, 0, onRetry);
 }
 
 
 //=============================================================================
 template <bcpp::implementation::signal_tree::level_traits_concept T>
-template <template <std::uint64_t, std::uint64_t> class select_function>
+template <template <std::uint64_t, std::uint64_t> class select_function, typename retry_function>
 inline auto bcpp::implementation::signal_tree::level<T>::select
 (
     // return the index of a child counter which is not zero (indicates that one of the leaf nodes
     // represented by this counter is set - a non zero value)
     bias_flags biasFlags,
-    node_index nodeIndex
+    node_index nodeIndex,
+    retry_function onRetry
 ) noexcept -> std::pair<signal_index, bool>
 {
     static auto constexpr bias_bits_consumed_to_select_counter = minimum_bit_count(counters_per_node) - 1;  // was node_count
 
-    auto [selectedCounter, nodeIsZero] = nodes_[nodeIndex]. template select<select_function>(biasFlags);
+    auto [selectedCounter, nodeIsZero] = nodes_[nodeIndex]. template select<select_function>(biasFlags, onRetry);
     biasFlags <<= bias_bits_consumed_to_select_counter;
 
     if constexpr (root_level_traits<T>)
@@ -170,7 +216,7 @@ inline auto bcpp::implementation::signal_tree::level<T>::select
     {
         static auto constexpr bias_bits_consumed_to_select_child_counter = minimum_bit_count(child_level_type::counters_per_node) - 1;
         select_bias_hint <<= bias_bits_consumed_to_select_child_counter;
-        auto [childSelectedCounter, _] = childLevel_. template select<select_function>(biasFlags, (nodeIndex * counters_per_node) + selectedCounter);
+        auto [childSelectedCounter, _] = childLevel_. template select<select_function>(biasFlags, (nodeIndex * counters_per_node) + selectedCounter, onRetry);
         selectedCounter *= counter_capacity;
         return {selectedCounter | childSelectedCounter, nodeIsZero};
     }
@@ -15,6 +15,13 @@ namespace bcpp::implementation::signal_tree
 
     static thread_local std::uint64_t select_bias_hint = 0;
 
+    // select calls its retry function once for each failed update (contention).
+    // the default does nothing.
+    struct ignore_select_retries
+    {
+        void operator()() const noexcept{}
+    };
+
     template <std::size_t N1, std::size_t N2>
     requires (is_power_of_two(N1))
     struct node_traits
@@ -57,12 +64,24 @@ namespace bcpp::implementation::signal_tree
             std::uint64_t
         ) noexcept;
 
+        std::pair<bool, std::uint64_t> set_bits
+        (
+            value_type
+        ) noexcept requires (leaf_node_traits<T>);
+
+        std::pair<bool, std::uint64_t> add
+        (
+            std::uint64_t,
+            std::uint64_t
+        ) noexcept requires (non_leaf_node_traits<T>);
+
         bool empty() const noexcept{return (value_ == 0);}
 
-        template <template <std::uint64_t, std::uint64_t> class>
+        template <template <std::uint64_t, std::uint64_t> class, typename retry_function>
         std::pair<signal_index, bool> select
         (
-            bias_flags
+            bias_flags,
+            retry_function
         ) noexcept;
 
     protected:
@@ -129,10 +148,42 @@ inline std::pair<bool, bool> bcpp::implementation::signal_tree::node<T>::set
 
 //=============================================================================
 template <bcpp::implementation::signal_tree::node_traits_concept T>
-template <template <std::uint64_t, std::uint64_t> class selector>
+inline std::pair<bool, std::uint64_t> bcpp::implementation::signal_tree::node<T>::set_bits
+(
+    // leaf node.  set several counter bits with a single fetch_or.
+    // returns whether the node was empty (root node only) and the number of 
+    // bits which were not already set.
+    value_type bits
+) noexcept requires (leaf_node_traits<T>)
+{
+    auto prev = value_.fetch_or(bits);
+    return {root_node_traits<T> && (prev == 0), static_cast<std::uint64_t>(std::popcount(bits & ~prev))};
+}
+
+
+//=============================================================================
+template <bcpp::implementation::signal_tree::node_traits_concept T>
+inline std::pair<bool, std::uint64_t> bcpp::implementation::signal_tree::node<T>::add
+(
+    // non-leaf node.  increment the counter associated with signalIndex by count 
+    // with a single fetch_add. return true if this transitioned a root node from 
+    // empty to non-empty (always true for non root nodes) along with count.
+    std::uint64_t signalIndex,
+    std::uint64_t count
+) noexcept requires (non_leaf_node_traits<T>)
+{
+    auto prev = value_.fetch_add(addend_[signalIndex / counter_capacity] * count);
+    return {(!root_node_traits<T>) || (prev == 0ull), count};
+}
+
+
+//=============================================================================
+template <bcpp::implementation::signal_tree::node_traits_concept T>
+template <template <std::uint64_t, std::uint64_t> class selector, typename retry_function>
 inline auto bcpp::implementation::signal_tree::node<T>::select
 (
-    bias_flags biasFlags
+    bias_flags biasFlags,
+    retry_function onRetry
 ) noexcept -> std::pair<signal_index, bool>
 {
     auto expected = value_.load();
@@ -151,6 +202,7 @@ inline auto bcpp::implementation::signal_tree::node<T>::select
             if (expected = value_.fetch_and(~bit); ((expected & bit) == bit))
                 return {counterIndex, (expected == bit)};
         }
+        onRetry();
     }
     return {invalid_signal_index, false}; 
 }
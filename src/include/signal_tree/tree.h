@@ -48,6 +48,43 @@ namespace bcpp
         };
 
 
+        //============================================================================= 
+        // selects the child with the most set signals (ignores the bias)
+        template <std::uint64_t total_counters, std::uint64_t bits_per_counter>
+        struct largest_child_selector
+        {
+            inline auto operator()
+            (
+                std::uint64_t,
+                std::uint64_t counters
+            ) const noexcept -> signal_index
+            {
+                if constexpr (bits_per_counter == 1)
+                {
+                    return (counters > 0) ? std::countl_zero(counters) : ~0ull;
+                }
+                else
+                {
+                    // work contract groups use this to select new contract ids.  but we could improve speed here
+                    // with a expression fold as total counters is never more than 8 and often 4 or 2.
+                    auto selected = ~0ull;
+                    auto max = 0ull;
+                    /*static*/ auto /*constexpr*/ counter_mask = ((1ull << bits_per_counter) - 1);
+                    for (auto i = 0ull; i < total_counters; ++i)
+                    {
+                        if ((counters & counter_mask) > max)
+                        {
+                            max = (counters & counter_mask);
+                            selected = i;
+                        }
+                        counters >>= bits_per_counter;
+                    }
+                    return (total_counters - selected - 1);
+                }
+            }
+        };
+
+
         //=====================================================================
         // TODO: hack.  write better when have time
         template <std::uint64_t N = 64>
@@ -94,6 +131,7 @@ namespace bcpp
         public:
 
             static auto constexpr capacity = N;
+            static auto constexpr level_count = root_level::level_count;
 
             static_assert(select_tree_size(capacity) == capacity, "invalid signal_tree capacity");
 
@@ -102,12 +140,20 @@ namespace bcpp
                 signal_index
             ) noexcept;
 
+            std::pair<bool, std::uint64_t> set_bits
+            (
+                signal_index,
+                std::uint64_t
+            ) noexcept;
+
             bool empty() const noexcept;
 
-            template <template <std::uint64_t, std::uint64_t> class = default_selector>
+            // the optional retry function is called for each failed update (contention)
+            template <template <std::uint64_t, std::uint64_t> class = default_selector, typename retry_function = ignore_select_retries>
             std::pair<signal_index, bool> select
             (
-                std::uint64_t
+                std::uint64_t,
+                retry_function = {}
             ) noexcept;
 
         private:
@@ -137,6 +183,21 @@ inline std::pair<bool, bool> bcpp::implementation::signal_tree::tree<N>::set
 }
 
 
+//=============================================================================
+template <std::size_t N>
+inline std::pair<bool, std::uint64_t> bcpp::implementation::signal_tree::tree<N>::set_bits
+(
+    // set the leaves of a single leaf node (64 signals).  signalIndex is the first signal
+    // of the leaf node and bit (0x8000000000000000 >> n) of bits sets signal (signalIndex + n).
+    // returns true if the tree moved from empty to non empty and the number of newly set signals.
+    signal_index signalIndex,
+    std::uint64_t bits
+) noexcept 
+{
+    return rootLevel_.set_bits(signalIndex, bits);
+}
+
+
 //=============================================================================
 template <std::size_t N>
 inline bool bcpp::implementation::signal_tree::tree<N>::empty
@@ -151,15 +212,16 @@ inline bool bcpp::implementation::signal_tree::tree<N>::empty
 
 //=============================================================================
 template <std::size_t N>
-template <template <std::uint64_t, std::uint64_t> class select_function>
+template <template <std::uint64_t, std::uint64_t> class select_function, typename retry_function>
 inline auto bcpp::implementation::signal_tree::tree<N>::select 
 (
     // select and return the index of a leaf which is 'set'
     // return invalid_signal_index if no leaf is 'set' (empty tree)
-    std::uint64_t bias
+    std::uint64_t bias,
+    retry_function onRetry
 ) noexcept -> std::pair<signal_index, bool>
 {
     static auto constexpr number_of_bias_bits = (65 - minimum_bit_count(capacity));
     bias <<= number_of_bias_bits;
-    return rootLevel_. template select<select_function>(bias);
+    return rootLevel_. template select<select_function>(bias, onRetry);
 }
@@ -1,3 +1,9 @@
 #pragma once
 
 #include "./work_contract/work_contract.h"
+#include "./work_contract/worker_pool.h"
+#include "./work_contract/numa_work_contract_group.h"
+#include "./work_contract/contract_coroutine.h"
+#include "./work_contract/contract_graph.h"
+#include "./work_contract/reactor.h"
+#include "./work_contract/ingress_contract.h"
@@ -0,0 +1,504 @@
+#pragma once
+
+#include "./work_contract.h"
+#include "./coroutine_frame_pool.h"
+
+#include <include/synchronization_mode.h>
+#include <include/non_copyable.h>
+
+#include <coroutine>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+
+namespace bcpp::implementation
+{
+
+    template <synchronization_mode T, typename R>
+    class contract_coroutine;
+
+
+    //=========================================================================
+    // how a completed coroutine resumes the coroutine which awaits it.  a coroutine
+    // which is bound to a group is scheduled (it is resumed by its own contract).
+    // otherwise it is resumed directly.
+    struct coroutine_continuation
+    {
+        std::coroutine_handle<>         handle_;
+        bool(*                          schedule_)(work_contract_id, void *){nullptr};
+        void *                          group_{nullptr};
+        work_contract_id                contractId_{};
+    };
+
+
+    //=========================================================================
+    // promise state which does not depend on the result type
+    template <synchronization_mode T>
+    class contract_coroutine_promise_base
+    {
+    public:
+
+        static auto constexpr mode = T;
+        using work_contract_group_type = work_contract_group<mode>;
+        using work_contract_type = work_contract<mode>;
+
+        // co_yield {} reschedules the coroutine as a contract (and suspends it)
+        struct reschedule{};
+
+        static void * operator new(std::size_t size){return coroutine_frame_pool::allocate(size);}
+
+        static void operator delete(void * address, std::size_t size) noexcept{coroutine_frame_pool::deallocate(address, size);}
+
+        std::suspend_never initial_suspend() const noexcept{return {};}
+
+        auto final_suspend() noexcept;
+
+        void unhandled_exception() noexcept{exception_ = std::current_exception();}
+
+        auto yield_value(reschedule) noexcept;
+
+        // resume on the specified group.  the coroutine's contract is created on
+        // first use (or when moving to another group) and is scheduled.  returns
+        // false (the coroutine is not suspended) if the contract can not be created.
+        bool resume_on
+        (
+            work_contract_group_type &,
+            std::coroutine_handle<>
+        );
+
+        bool set_continuation(coroutine_continuation) noexcept;
+
+        bool is_done() const noexcept{return (state_.load(std::memory_order_acquire) == state::done);}
+
+        bool is_bound() const noexcept{return (group_ != nullptr);}
+
+        work_contract_group_type * get_group() const noexcept{return group_;}
+
+        work_contract_id get_contract_id() const noexcept{return contract_.get_id();}
+
+        // one reference is held by the contract_coroutine and one by the coroutine
+        // itself until it completes.  the frame is destroyed when both are gone.
+        bool drop_reference() noexcept{return (--referenceCount_ == 0);}
+
+    protected:
+
+        enum class state : std::uint32_t
+        {
+            running,
+            awaited,
+            done
+        };
+
+        work_contract_type                      contract_;
+        work_contract_group_type *              group_{nullptr};
+        coroutine_continuation                  continuation_;
+        std::atomic<state>                      state_{state::running};
+        std::atomic<std::uint32_t>              referenceCount_{2};
+        std::exception_ptr                      exception_;
+
+    }; // class contract_coroutine_promise_base
+
+
+    //=========================================================================
+    template <synchronization_mode T, typename R>
+    class contract_coroutine_promise :
+        public contract_coroutine_promise_base<T>
+    {
+    public:
+
+        contract_coroutine<T, R> get_return_object() noexcept;
+
+        template <typename V>
+        void return_value(V && value){result_.emplace(std::forward<V>(value));}
+
+        R get_result()
+        {
+            if (this->exception_)
+                std::rethrow_exception(this->exception_);
+            return std::move(*result_);
+        }
+
+    private:
+
+        std::optional<R>                        result_;
+
+    }; // class contract_coroutine_promise
+
+
+    //=========================================================================
+    template <synchronization_mode T>
+    class contract_coroutine_promise<T, void> :
+        public contract_coroutine_promise_base<T>
+    {
+    public:
+
+        contract_coroutine<T, void> get_return_object() noexcept;
+
+        void return_void() noexcept{}
+
+        void get_result()
+        {
+            if (this->exception_)
+                std::rethrow_exception(this->exception_);
+        }
+
+    }; // class contract_coroutine_promise
+
+
+    //=========================================================================
+    // co_await of a contract_coroutine
+    template <synchronization_mode T, typename R>
+    class completion_awaiter
+    {
+    public:
+
+        explicit completion_awaiter
+        (
+            std::coroutine_handle<contract_coroutine_promise<T, R>> handle
+        ) noexcept :
+            handle_(handle)
+        {
+        }
+
+        bool await_ready() const noexcept{return handle_.promise().is_done();}
+
+        template <synchronization_mode M, typename P>
+        bool await_suspend
+        (
+            std::coroutine_handle<contract_coroutine_promise<M, P>>
+        ) noexcept;
+
+        R await_resume(){return handle_.promise().get_result();}
+
+    private:
+
+        std::coroutine_handle<contract_coroutine_promise<T, R>> handle_;
+
+    }; // class completion_awaiter
+
+
+    //=========================================================================
+    // the result of a coroutine whose resumptions are work contracts.  the coroutine
+    // starts eagerly on the calling thread.  co_await group.schedule() suspends it
+    // and continues it as a contract of that group.  from then on co_yield {}
+    // reschedules it (this_contract::schedule()) and co_await of another contract_coroutine
+    // schedules it again once the other coroutine completes.  no allocation takes
+    // place per suspension and frames are taken from a recycling pool.  the frame is
+    // shared by the contract_coroutine and the running coroutine so dropping the
+    // contract_coroutine detaches the coroutine rather than destroying it.
+    // the coroutine must be allowed to run to completion (the group must not be
+    // stopped while it is suspended).
+    template <synchronization_mode T, typename R = void>
+    class contract_coroutine :
+        non_copyable
+    {
+    public:
+
+        using promise_type = contract_coroutine_promise<T, R>;
+
+        contract_coroutine() = default;
+
+        contract_coroutine(contract_coroutine &&) noexcept;
+
+        contract_coroutine & operator = (contract_coroutine &&) noexcept;
+
+        ~contract_coroutine();
+
+        bool is_done() const noexcept;
+
+        // the coroutine's result (or exception).  requires is_done().
+        R get();
+
+        completion_awaiter<T, R> operator co_await() noexcept;
+
+    private:
+
+        friend promise_type;
+
+        explicit contract_coroutine
+        (
+            std::coroutine_handle<promise_type> handle
+        ) noexcept :
+            handle_(handle)
+        {
+        }
+
+        std::coroutine_handle<promise_type>     handle_;
+
+    }; // class contract_coroutine
+
+
+    //=========================================================================
+    // co_await group.schedule().  yields true if the coroutine now runs as a contract
+    // of the group.  false if the group could not create a contract (it is full and
+    // can not grow, as when it has been stopped) in which case the coroutine continues
+    // without suspending.
+    template <synchronization_mode T>
+    class schedule_operation
+    {
+    public:
+
+        explicit schedule_operation
+        (
+            work_contract_group<T> & group
+        ) noexcept :
+            group_(group)
+        {
+        }
+
+        bool await_ready() const noexcept{return false;}
+
+        template <typename R>
+        bool await_suspend(std::coroutine_handle<contract_coroutine_promise<T, R>> handle){return (scheduled_ = handle.promise().resume_on(group_, handle));}
+
+        bool await_resume() const noexcept{return scheduled_;}
+
+    private:
+
+        work_contract_group<T> &                group_;
+
+        bool                                    scheduled_{false};
+
+    }; // class schedule_operation
+
+} // namespace bcpp::implementation
+
+
+namespace bcpp
+{
+
+    template <typename R = void>
+    using contract_coroutine = implementation::contract_coroutine<synchronization_mode::non_blocking, R>;
+
+    template <typename R = void>
+    using blocking_contract_coroutine = implementation::contract_coroutine<synchronization_mode::blocking, R>;
+
+} // namespace bcpp
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline auto bcpp::implementation::work_contract_group<T>::schedule
+(
+    // co_await group.schedule() continues the awaiting contract_coroutine as a contract of this group
+) noexcept -> schedule_operation<mode>
+{
+    return schedule_operation<mode>(*this);
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline bool bcpp::implementation::contract_coroutine_promise_base<T>::resume_on
+(
+    // the coroutine is suspended.  it may be resumed (by a worker) as soon as it is
+    // scheduled so nothing in the frame is touched after that.  if the group can not
+    // create a contract then the coroutine keeps its current contract (if any) and
+    // is resumed inline rather than scheduling an invalid contract id.
+    work_contract_group_type & group,
+    std::coroutine_handle<> handle
+)
+{
+    if (group_ != &group)
+    {
+        auto contract = group.create_contract([handle](){handle.resume();});
+        if (!contract.is_valid())
+            return false;
+        // replacing the contract releases the contract of the previous group (if any)
+        contract_ = std::move(contract);
+        group_ = &group;
+        group.schedule(contract_.get_id());
+        return true;
+    }
+    this_contract::schedule();
+    return true;
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline auto bcpp::implementation::contract_coroutine_promise_base<T>::yield_value
+(
+    reschedule
+) noexcept
+{
+    struct awaiter
+    {
+        bool suspend_;
+        bool await_ready() const noexcept{return !suspend_;}
+        void await_suspend(std::coroutine_handle<>) const noexcept{this_contract::schedule();}
+        void await_resume() const noexcept{}
+    };
+    // yielding before the coroutine is bound to a group has no effect
+    return awaiter{group_ != nullptr};
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline bool bcpp::implementation::contract_coroutine_promise_base<T>::set_continuation
+(
+    // returns false (the awaiting coroutine should not suspend) if the coroutine
+    // has already completed
+    coroutine_continuation continuation
+) noexcept
+{
+    continuation_ = continuation;
+    auto expected = state::running;
+    return state_.compare_exchange_strong(expected, state::awaited, std::memory_order_acq_rel);
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline auto bcpp::implementation::contract_coroutine_promise_base<T>::final_suspend
+(
+    // release the coroutine's contract, wake any awaiting coroutine and destroy the
+    // frame if the contract_coroutine no longer exists.
+) noexcept
+{
+    struct awaiter
+    {
+        bool await_ready() const noexcept{return false;}
+
+        std::coroutine_handle<> await_suspend
+        (
+            std::coroutine_handle<> handle
+        ) noexcept
+        {
+            auto & promise = promise_;
+            promise.contract_.release();
+            // the continuation is only read (and is only complete) if it was registered
+            auto awaited = (promise.state_.exchange(state::done, std::memory_order_acq_rel) == state::awaited);
+            auto continuation = awaited ? promise.continuation_ : coroutine_continuation{};
+            if (promise.drop_reference())
+                handle.destroy();
+            if (awaited)
+            {
+                if (continuation.schedule_ == nullptr)
+                    return continuation.handle_;
+                continuation.schedule_(continuation.contractId_, continuation.group_);
+            }
+            return std::noop_coroutine();
+        }
+
+        void await_resume() const noexcept{}
+
+        contract_coroutine_promise_base & promise_;
+    };
+    return awaiter{*this};
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T, typename R>
+inline auto bcpp::implementation::contract_coroutine_promise<T, R>::get_return_object
+(
+) noexcept -> contract_coroutine<T, R>
+{
+    return contract_coroutine<T, R>(std::coroutine_handle<contract_coroutine_promise>::from_promise(*this));
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline auto bcpp::implementation::contract_coroutine_promise<T, void>::get_return_object
+(
+) noexcept -> contract_coroutine<T, void>
+{
+    return contract_coroutine<T, void>(std::coroutine_handle<contract_coroutine_promise>::from_promise(*this));
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T, typename R>
+inline bcpp::implementation::contract_coroutine<T, R>::contract_coroutine
+(
+    contract_coroutine && other
+) noexcept :
+    handle_(std::exchange(other.handle_, nullptr))
+{
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T, typename R>
+inline auto bcpp::implementation::contract_coroutine<T, R>::operator =
+(
+    contract_coroutine && other
+) noexcept -> contract_coroutine &
+{
+    if (this != &other)
+    {
+        if ((handle_) && (handle_.promise().drop_reference()))
+            handle_.destroy();
+        handle_ = std::exchange(other.handle_, nullptr);
+    }
+    return *this;
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T, typename R>
+inline bcpp::implementation::contract_coroutine<T, R>::~contract_coroutine
+(
+)
+{
+    if ((handle_) && (handle_.promise().drop_reference()))
+        handle_.destroy();
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T, typename R>
+inline bool bcpp::implementation::contract_coroutine<T, R>::is_done
+(
+) const noexcept
+{
+    return ((handle_) && (handle_.promise().is_done()));
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T, typename R>
+inline R bcpp::implementation::contract_coroutine<T, R>::get
+(
+)
+{
+    return handle_.promise().get_result();
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T, typename R>
+inline auto bcpp::implementation::contract_coroutine<T, R>::operator co_await
+(
+) noexcept -> completion_awaiter<T, R>
+{
+    return completion_awaiter<T, R>(handle_);
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T, typename R>
+template <bcpp::synchronization_mode M, typename P>
+inline bool bcpp::implementation::completion_awaiter<T, R>::await_suspend
+(
+    // the awaiting coroutine is scheduled (or, if not bound to a group, resumed)
+    // once the awaited coroutine completes.  returns false if it already has.
+    std::coroutine_handle<contract_coroutine_promise<M, P>> awaitingHandle
+) noexcept
+{
+    static constexpr bool(*schedule)(work_contract_id, void *) = [](work_contract_id contractId, void * group)
+            {
+                return reinterpret_cast<work_contract_group<M> *>(group)->schedule(contractId);
+            };
+    coroutine_continuation continuation{awaitingHandle};
+    if (auto & awaitingPromise = awaitingHandle.promise(); awaitingPromise.is_bound())
+        continuation = {awaitingHandle, schedule, awaitingPromise.get_group(), awaitingPromise.get_contract_id()};
+    return handle_.promise().set_continuation(continuation);
+}
@@ -0,0 +1,331 @@
+#pragma once
+
+#include "./work_contract.h"
+
+#include <include/synchronization_mode.h>
+#include <include/non_copyable.h>
+#include <include/non_movable.h>
+
+#include <atomic>
+#include <concepts>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+namespace bcpp::implementation
+{
+
+    //=========================================================================
+    // a directed acyclic graph of work contracts.  nodes and edges are declared
+    // up front and each run() executes every node once, a node's contract being
+    // scheduled when the last of its predecessors completes.  dependencies are
+    // tracked with one atomic pending count per node (cache line padded) so no locks
+    // are involved.  the successor lists are flattened into a single array on the
+    // first run after the graph is modified so re-running the graph allocates nothing.
+    // the graph must not be modified, or destroyed, while a run is in progress.
+    // a node whose work throws is still complete (the group's exception handler
+    // sees the exception and the node's successors are released as usual).
+    template <synchronization_mode T>
+    class contract_graph :
+        non_copyable,
+        non_movable
+    {
+    public:
+
+        static auto constexpr mode = T;
+        using work_contract_group_type = work_contract_group<mode>;
+        using work_contract_type = work_contract<mode>;
+        using node_id = std::uint32_t;
+
+        explicit contract_graph
+        (
+            work_contract_group_type &
+        );
+
+        ~contract_graph() = default;
+
+        node_id add_node
+        (
+            std::invocable auto &&
+        );
+
+        // the node 'to' will not run until the node 'from' has completed
+        void add_edge
+        (
+            node_id,
+            node_id
+        );
+
+        // returns false (and runs nothing) if the graph contains a cycle
+        bool run();
+
+        bool is_complete() const noexcept;
+
+        // blocks until every sink node of the current run has completed
+        void wait() const noexcept;
+
+        std::size_t node_count() const noexcept;
+
+    private:
+
+        struct alignas(64) pending_count
+        {
+            std::atomic<std::uint32_t>  value_;
+        };
+
+        bool finalize();
+
+        // completes the node (even if its work throws)
+        class auto_complete_node;
+
+        void on_node_complete
+        (
+            node_id
+        ) noexcept;
+
+        work_contract_group_type &                  group_;
+
+        std::vector<work_contract_type>             contracts_;
+
+        std::vector<std::pair<node_id, node_id>>    edges_;
+
+        bool                                        finalized_{true};
+
+        // built by finalize()
+        std::vector<work_contract_id>               contractIds_;
+
+        std::vector<std::uint32_t>                  predecessorCount_;
+
+        std::vector<std::uint32_t>                  firstSuccessor_;    // node_count() + 1 entries
+
+        std::vector<node_id>                        successors_;
+
+        std::vector<node_id>                        roots_;
+
+        std::uint32_t                               sinkCount_{0};
+
+        std::unique_ptr<pending_count[]>            pending_;
+
+        // one more than the number of sink nodes (those without successors) yet to
+        // complete while a run is in progress.  the last sink to complete leaves 1
+        // until it has notified any waiters, so the graph is not complete (and can
+        // not be destroyed) while that sink is still using it.
+        alignas(64) std::atomic<std::uint32_t>      remaining_{0};
+
+    }; // class contract_graph
+
+} // namespace bcpp::implementation
+
+
+namespace bcpp
+{
+
+    using contract_graph = implementation::contract_graph<synchronization_mode::non_blocking>;
+    using blocking_contract_graph = implementation::contract_graph<synchronization_mode::blocking>;
+
+} // namespace bcpp
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+class bcpp::implementation::contract_graph<T>::auto_complete_node
+{
+public:
+    auto_complete_node(contract_graph & owner, node_id nodeId) noexcept:owner_(owner), nodeId_(nodeId){}
+    ~auto_complete_node(){owner_.on_node_complete(nodeId_);}
+private:
+    contract_graph &    owner_;
+    node_id             nodeId_;
+};
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline bcpp::implementation::contract_graph<T>::contract_graph
+(
+    work_contract_group_type & group
+):
+    group_(group)
+{
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline auto bcpp::implementation::contract_graph<T>::add_node
+(
+    // the node's work is executed as a contract of the graph's group
+    std::invocable auto && workFunction
+) -> node_id
+{
+    auto nodeId = static_cast<node_id>(contracts_.size());
+    contracts_.push_back(group_.create_contract(
+            [this, nodeId, work = std::forward<std::decay_t<decltype(workFunction)>>(workFunction)]() mutable
+            {
+                auto_complete_node autoCompleteNode(*this, nodeId);
+                work();
+            }));
+    finalized_ = false;
+    return nodeId;
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline void bcpp::implementation::contract_graph<T>::add_edge
+(
+    node_id from,
+    node_id to
+)
+{
+    edges_.emplace_back(from, to);
+    finalized_ = false;
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline bool bcpp::implementation::contract_graph<T>::finalize
+(
+    // flatten the edges into per node successor ranges (counting sort by source node).
+    // returns false if the graph contains a cycle (or an edge to an unknown node).
+)
+{
+    auto nodeCount = contracts_.size();
+    contractIds_.clear();
+    for (auto const & contract : contracts_)
+        contractIds_.push_back(contract.get_id());
+    predecessorCount_.assign(nodeCount, 0);
+    firstSuccessor_.assign(nodeCount + 1, 0);
+    for (auto [from, to] : edges_)
+    {
+        if ((from >= nodeCount) || (to >= nodeCount))
+            return false;
+        ++firstSuccessor_[from + 1];
+        ++predecessorCount_[to];
+    }
+    for (auto i = 0ull; i < nodeCount; ++i)
+        firstSuccessor_[i + 1] += firstSuccessor_[i];
+    successors_.resize(edges_.size());
+    std::vector<std::uint32_t> position(firstSuccessor_.begin(), firstSuccessor_.end() - 1);
+    for (auto [from, to] : edges_)
+        successors_[position[from]++] = to;
+
+    roots_.clear();
+    sinkCount_ = 0;
+    for (auto i = 0u; i < nodeCount; ++i)
+    {
+        if (predecessorCount_[i] == 0)
+            roots_.push_back(i);
+        sinkCount_ += (firstSuccessor_[i] == firstSuccessor_[i + 1]);
+    }
+
+    // every node must be reachable by repeatedly removing nodes without predecessors
+    std::vector<std::uint32_t> count(predecessorCount_);
+    std::vector<node_id> ready(roots_);
+    auto visited = 0ull;
+    while (!ready.empty())
+    {
+        auto nodeId = ready.back();
+        ready.pop_back();
+        ++visited;
+        for (auto i = firstSuccessor_[nodeId]; i < firstSuccessor_[nodeId + 1]; ++i)
+            if (--count[successors_[i]] == 0)
+                ready.push_back(successors_[i]);
+    }
+    if (visited != nodeCount)
+        return false;
+
+    pending_ = std::make_unique<pending_count[]>(nodeCount);
+    finalized_ = true;
+    return true;
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline bool bcpp::implementation::contract_graph<T>::run
+(
+    // execute every node of the graph once.  returns false if the graph has a
+    // cycle or if the previous run has not yet completed.
+)
+{
+    if (!is_complete())
+        return false;
+    if ((!finalized_) && (!finalize()))
+        return false;
+    if (roots_.empty())
+        return true;
+
+    for (auto i = 0ull; i < contracts_.size(); ++i)
+        pending_[i].value_.store(predecessorCount_[i], std::memory_order_relaxed);
+    remaining_.store(sinkCount_ + 1, std::memory_order_release);
+    for (auto nodeId : roots_)
+        group_.schedule(contractIds_[nodeId]);
+    return true;
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline void bcpp::implementation::contract_graph<T>::on_node_complete
+(
+    // release the node's successors.  the successor whose pending count reaches
+    // zero is scheduled by whichever predecessor completed last.  the final store
+    // by the last sink is the last access to the graph by any node of the run.
+    node_id nodeId
+) noexcept
+{
+    auto first = firstSuccessor_[nodeId];
+    auto last = firstSuccessor_[nodeId + 1];
+    if (first == last)
+    {
+        if (remaining_.fetch_sub(1, std::memory_order_acq_rel) == 2)
+        {
+            remaining_.notify_all();
+            remaining_.store(0, std::memory_order_release);
+        }
+        return;
+    }
+    for (auto i = first; i < last; ++i)
+        if (auto successor = successors_[i]; pending_[successor].value_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            group_.schedule(contractIds_[successor]);
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline bool bcpp::implementation::contract_graph<T>::is_complete
+(
+) const noexcept
+{
+    return (remaining_.load(std::memory_order_acquire) == 0);
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline void bcpp::implementation::contract_graph<T>::wait
+(
+    // block until the current run has completed.  once every sink has completed
+    // only the (brief) notification of the last sink remains so that is spun on.
+) const noexcept
+{
+    for (auto remaining = remaining_.load(std::memory_order_acquire); remaining > 1; remaining = remaining_.load(std::memory_order_acquire))
+        remaining_.wait(remaining, std::memory_order_acquire);
+    while (remaining_.load(std::memory_order_acquire) != 0)
+        std::this_thread::yield();
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline std::size_t bcpp::implementation::contract_graph<T>::node_count
+(
+) const noexcept
+{
+    return contracts_.size();
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <new>
+#include <utility>
+
+
+namespace bcpp::implementation
+{
+
+    //=========================================================================
+    // recycles coroutine frames.  frames are cache line aligned (so promises with
+    // 64 byte aligned members, such as work_contract, are correctly aligned) and 
+    // are rounded up to a multiple of 64 bytes.  each thread caches up to 
+    // max_cached_frames freed frames of each size class (frames larger than 
+    // max_pooled_size are not pooled).  a frame freed on a thread other than the one
+    // which allocated it joins the freeing thread's cache.  no locks or atomics are involved.
+    class coroutine_frame_pool
+    {
+    public:
+
+        static void * allocate
+        (
+            std::size_t
+        );
+
+        static void deallocate
+        (
+            void *,
+            std::size_t
+        ) noexcept;
+
+    private:
+
+        static auto constexpr size_class_granularity = 64ull;
+        static auto constexpr size_class_count = 16ull;
+        static auto constexpr max_pooled_size = (size_class_granularity * size_class_count);
+        static auto constexpr max_cached_frames = 64u;
+        static auto constexpr frame_alignment = std::align_val_t{size_class_granularity};
+
+        struct free_frame
+        {
+            free_frame * next_;
+        };
+
+        struct cache
+        {
+            ~cache()
+            {
+                for (auto head : head_)
+                    while (head)
+                        ::operator delete(std::exchange(head, head->next_), frame_alignment);
+            }
+
+            std::array<free_frame *, size_class_count>  head_{};
+            std::array<std::uint32_t, size_class_count> count_{};
+        };
+
+        static std::size_t size_class
+        (
+            std::size_t size
+        ) noexcept
+        {
+            return ((size + size_class_granularity - 1) / size_class_granularity) - 1;
+        }
+
+        static thread_local cache tls_cache_;
+
+    }; // class coroutine_frame_pool
+
+    inline thread_local coroutine_frame_pool::cache coroutine_frame_pool::tls_cache_;
+
+} // namespace bcpp::implementation
+
+
+//=============================================================================
+inline void * bcpp::implementation::coroutine_frame_pool::allocate
+(
+    std::size_t size
+)
+{
+    if (size > max_pooled_size)
+        return ::operator new(size, frame_alignment);
+    auto sizeClass = size_class(size);
+    auto & cache = tls_cache_;
+    if (auto frame = cache.head_[sizeClass]; frame != nullptr)
+    {
+        cache.head_[sizeClass] = frame->next_;
+        --cache.count_[sizeClass];
+        return frame;
+    }
+    return ::operator new((sizeClass + 1) * size_class_granularity, frame_alignment);
+}
+
+
+//=============================================================================
+inline void bcpp::implementation::coroutine_frame_pool::deallocate
+(
+    void * address,
+    std::size_t size
+) noexcept
+{
+    if (size > max_pooled_size)
+    {
+        ::operator delete(address, frame_alignment);
+        return;
+    }
+    auto sizeClass = size_class(size);
+    auto & cache = tls_cache_;
+    if (cache.count_[sizeClass] >= max_cached_frames)
+    {
+        ::operator delete(address, frame_alignment);
+        return;
+    }
+    cache.head_[sizeClass] = new (address) free_frame{cache.head_[sizeClass]};
+    ++cache.count_[sizeClass];
+}
@@ -0,0 +1,214 @@
+#include "./cpu_topology.h"
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <tuple>
+
+#include <sched.h>
+
+
+namespace
+{
+
+    auto constexpr sysfs_cpu_path = "/sys/devices/system/cpu";
+
+
+    //=========================================================================
+    std::vector<std::uint32_t> parse_cpu_list
+    (
+        // parse the sysfs cpu list format.  ex: "0-3,8,10-11"
+        std::string const & cpuList
+    )
+    {
+        std::vector<std::uint32_t> result;
+        std::size_t pos = 0;
+        while (pos < cpuList.size())
+        {
+            auto end = cpuList.find(',', pos);
+            if (end == std::string::npos)
+                end = cpuList.size();
+            auto range = cpuList.substr(pos, end - pos);
+            if (auto dash = range.find('-'); dash != std::string::npos)
+            {
+                auto first = std::stoul(range.substr(0, dash));
+                auto last = std::stoul(range.substr(dash + 1));
+                for (auto cpu = first; cpu <= last; ++cpu)
+                    result.push_back(cpu);
+            }
+            else if (!range.empty())
+            {
+                result.push_back(std::stoul(range));
+            }
+            pos = (end + 1);
+        }
+        return result;
+    }
+
+
+    //=========================================================================
+    bool read_value
+    (
+        std::filesystem::path const & path,
+        std::string & value
+    )
+    {
+        std::ifstream stream(path);
+        return (stream && std::getline(stream, value) && !value.empty());
+    }
+
+
+    //=========================================================================
+    std::uint32_t read_uint
+    (
+        std::filesystem::path const & path,
+        std::uint32_t defaultValue
+    )
+    {
+        std::string value;
+        if (!read_value(path, value))
+            return defaultValue;
+        try
+        {
+            return std::stoul(value);
+        }
+        catch (...)
+        {
+            return defaultValue;
+        }
+    }
+
+
+    //=========================================================================
+    std::uint32_t find_numa_node
+    (
+        // sysfs exposes the node of each cpu as a nodeN entry in the cpu's directory
+        std::filesystem::path const & cpuPath
+    )
+    {
+        std::error_code errorCode;
+        for (auto const & entry : std::filesystem::directory_iterator(cpuPath, errorCode))
+        {
+            auto name = entry.path().filename().string();
+            if ((name.size() > 4) && (name.starts_with("node")) && (std::all_of(name.begin() + 4, name.end(), ::isdigit)))
+                return std::stoul(name.substr(4));
+        }
+        return 0;
+    }
+
+} // namespace
+
+
+//=============================================================================
+bcpp::cpu_topology::cpu_topology
+(
+)
+{
+    std::vector<std::uint32_t> onlineCpus;
+    if (std::string cpuList; read_value(std::filesystem::path(sysfs_cpu_path) / "online", cpuList))
+        onlineCpus = parse_cpu_list(cpuList);
+    if (onlineCpus.empty())
+        for (auto i = 0u; i < std::max(1u, std::thread::hardware_concurrency()); ++i)
+            onlineCpus.push_back(i);
+
+    cpu_set_t affinity;
+    CPU_ZERO(&affinity);
+    auto haveAffinity = (sched_getaffinity(0, sizeof(affinity), &affinity) == 0);
+
+    for (auto cpu : onlineCpus)
+    {
+        if ((haveAffinity) && (cpu < CPU_SETSIZE) && (!CPU_ISSET(cpu, &affinity)))
+            continue;
+        auto cpuPath = std::filesystem::path(sysfs_cpu_path) / ("cpu" + std::to_string(cpu));
+        logicalCpus_.push_back({
+                .id_ = cpu,
+                .coreId_ = read_uint(cpuPath / "topology" / "core_id", cpu),
+                .packageId_ = read_uint(cpuPath / "topology" / "physical_package_id", 0),
+                .numaNode_ = find_numa_node(cpuPath),
+                .siblingIndex_ = 0});
+    }
+
+    if (logicalCpus_.empty())
+        logicalCpus_.push_back({.id_ = 0, .coreId_ = 0, .packageId_ = 0, .numaNode_ = 0, .siblingIndex_ = 0});
+
+    // number the smt threads of each physical core in order of cpu id
+    std::sort(logicalCpus_.begin(), logicalCpus_.end(), [](auto const & a, auto const & b)
+            {
+                return std::tie(a.packageId_, a.coreId_, a.id_) < std::tie(b.packageId_, b.coreId_, b.id_);
+            });
+    for (auto i = 1ull; i < logicalCpus_.size(); ++i)
+    {
+        auto & prev = logicalCpus_[i - 1];
+        auto & cur = logicalCpus_[i];
+        if ((cur.packageId_ == prev.packageId_) && (cur.coreId_ == prev.coreId_))
+            cur.siblingIndex_ = (prev.siblingIndex_ + 1);
+    }
+    std::sort(logicalCpus_.begin(), logicalCpus_.end(), [](auto const & a, auto const & b){return (a.id_ < b.id_);});
+}
+
+
+//=============================================================================
+auto bcpp::cpu_topology::logical_cpus
+(
+) const -> std::span<logical_cpu const>
+{
+    return logicalCpus_;
+}
+
+
+//=============================================================================
+std::vector<std::uint32_t> bcpp::cpu_topology::physical_cores
+(
+) const
+{
+    return cpus(false);
+}
+
+
+//=============================================================================
+std::vector<std::uint32_t> bcpp::cpu_topology::cpus
+(
+    bool includeSmtSiblings
+) const
+{
+    std::vector<logical_cpu> selected;
+    for (auto const & logicalCpu : logicalCpus_)
+        if ((includeSmtSiblings) || (logicalCpu.siblingIndex_ == 0))
+            selected.push_back(logicalCpu);
+    std::stable_sort(selected.begin(), selected.end(), [](auto const & a, auto const & b){return (a.siblingIndex_ < b.siblingIndex_);});
+
+    std::vector<std::uint32_t> result;
+    for (auto const & logicalCpu : selected)
+        result.push_back(logicalCpu.id_);
+    return result;
+}
+
+
+//=============================================================================
+std::vector<std::uint32_t> bcpp::cpu_topology::cpus
+(
+    bool includeSmtSiblings,
+    std::uint32_t numaNode
+) const
+{
+    std::vector<std::uint32_t> result;
+    for (auto cpu : cpus(includeSmtSiblings))
+        if (auto iter = std::find_if(logicalCpus_.begin(), logicalCpus_.end(), [cpu](auto const & c){return (c.id_ == cpu);}); iter->numaNode_ == numaNode)
+            result.push_back(cpu);
+    return result;
+}
+
+
+//=============================================================================
+std::uint32_t bcpp::cpu_topology::numa_node_count
+(
+) const
+{
+    std::uint32_t maxNode = 0;
+    for (auto const & logicalCpu : logicalCpus_)
+        maxNode = std::max(maxNode, logicalCpu.numaNode_);
+    return (maxNode + 1);
+}
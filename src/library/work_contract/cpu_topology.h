@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <span>
+
+
+namespace bcpp
+{
+
+    //=========================================================================
+    // the logical cpus available to this process (its affinity mask) along with
+    // the physical core, package and numa node of each.  discovered from sysfs
+    // (/sys/devices/system/cpu) at construction.  where sysfs is unavailable each
+    // logical cpu is treated as its own physical core on package and node zero.
+    class cpu_topology
+    {
+    public:
+
+        struct logical_cpu
+        {
+            std::uint32_t   id_;
+            std::uint32_t   coreId_;            // physical core id (unique within its package)
+            std::uint32_t   packageId_;
+            std::uint32_t   numaNode_;
+            std::uint32_t   siblingIndex_;      // zero for the first smt thread of its physical core
+        };
+
+        cpu_topology();
+
+        std::span<logical_cpu const> logical_cpus() const;
+
+        // one logical cpu per physical core (the first smt thread of each)
+        std::vector<std::uint32_t> physical_cores() const;
+
+        // every logical cpu ordered such that the first smt thread of every physical core
+        // comes before any second smt thread (and so on).  without smt siblings this is
+        // the same as physical_cores().
+        std::vector<std::uint32_t> cpus
+        (
+            bool
+        ) const;
+
+        // as above but restricted to the specified numa node
+        std::vector<std::uint32_t> cpus
+        (
+            bool,
+            std::uint32_t
+        ) const;
+
+        std::uint32_t numa_node_count() const;
+
+    private:
+
+        std::vector<logical_cpu>    logicalCpus_;
+
+    }; // class cpu_topology
+
+} // namespace bcpp
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+#include <chrono>
+
+
+namespace bcpp
+{
+
+    // contracts created in an execution lane are only selected by the workers which
+    // execute that lane (execute_next_contract(execution_lane{n})).  lanes follow 
+    // the priority bands of a group and are configured when the group is constructed.
+    enum class execution_lane : std::uint64_t {};
+
+
+    struct lane_configuration
+    {
+        std::uint64_t               laneCount_{0};
+        // zero: lane contracts are never selected by other workers.  otherwise a worker 
+        // which finds no other scheduled contracts may select from a lane once the lane's
+        // own workers have not selected from it for this long while it has scheduled contracts.
+        // in blocking mode this only happens while the general workers are awake (each lane
+        // has its own waitable state so scheduling a lane contract wakes only its own workers).
+        std::chrono::microseconds   stealAfter_{0};
+    };
+
+} // namespace bcpp
@@ -0,0 +1,99 @@
+#include "./execution_trace.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <set>
+
+
+//=============================================================================
+bcpp::implementation::trace_buffer::trace_buffer
+(
+):
+    entries_(std::make_unique<entry[]>(capacity))
+{
+}
+
+
+//=============================================================================
+void bcpp::implementation::trace_buffer::copy_to
+(
+    // append the buffered events (oldest first).  may be called by any thread while
+    // the writer continues to record.
+    std::vector<trace_event> & events,
+    std::uint32_t thread
+) const
+{
+    auto head = std::atomic_ref(const_cast<std::uint64_t &>(head_)).load(std::memory_order_acquire);
+    auto first = (head > capacity) ? (head - capacity) : 0;
+    std::vector<entry> copy(head - first);
+    for (auto i = first; i < head; ++i)
+    {
+        auto & source = const_cast<entry &>(entries_[i & (capacity - 1)]);
+        copy[i - first] = {std::atomic_ref(source.time_).load(std::memory_order_relaxed), 
+                std::atomic_ref(source.value_).load(std::memory_order_relaxed)};
+    }
+    // discard the slots which the writer may have overwritten while they were copied
+    std::atomic_thread_fence(std::memory_order_acquire);
+    auto latestHead = std::atomic_ref(const_cast<std::uint64_t &>(head_)).load(std::memory_order_relaxed);
+    auto firstValid = std::max(first, (latestHead >= capacity) ? (latestHead - capacity + 1) : 0);
+    for (auto i = firstValid; i < head; ++i)
+    {
+        auto [time, value] = copy[i - first];
+        events.push_back({time, (value & contract_id_mask), static_cast<trace_event_type>(value >> type_shift), thread});
+    }
+}
+
+
+//=============================================================================
+void bcpp::write_chrome_trace
+(
+    // timestamps are microseconds from the earliest event
+    std::ostream & stream,
+    std::span<trace_event const> events
+)
+{
+    auto baseTime = events.empty() ? 0ull : std::min_element(events.begin(), events.end(), 
+            [](auto const & a, auto const & b){return (a.time_ < b.time_);})->time_;
+    auto ticksPerMicrosecond = (implementation::tsc_ticks_per_nanosecond() * 1000.0);
+
+    stream << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    auto separator = "\n";
+    std::set<std::uint32_t> threads;
+    for (auto const & event : events)
+        threads.insert(event.thread_);
+    for (auto thread : threads)
+    {
+        stream << separator << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread << ",\"args\":{\"name\":\"thread " << thread << "\"}}";
+        separator = ",\n";
+    }
+
+    auto flags = stream.flags();
+    stream << std::fixed << std::setprecision(3);
+    for (auto const & event : events)
+    {
+        stream << separator;
+        separator = ",\n";
+        auto timeStamp = ((event.time_ - baseTime) / ticksPerMicrosecond);
+        switch (event.type_)
+        {
+            case trace_event_type::start:
+                stream << "{\"name\":\"contract " << event.contractId_ << "\",\"cat\":\"work_contract\",\"ph\":\"B\"";
+                break;
+            case trace_event_type::end:
+                stream << "{\"ph\":\"E\"";
+                break;
+            case trace_event_type::schedule:
+                stream << "{\"name\":\"schedule " << event.contractId_ << "\",\"cat\":\"work_contract\",\"ph\":\"i\",\"s\":\"t\"";
+                break;
+            case trace_event_type::release:
+                stream << "{\"name\":\"release " << event.contractId_ << "\",\"cat\":\"work_contract\",\"ph\":\"i\",\"s\":\"t\"";
+                break;
+            case trace_event_type::exception:
+                stream << "{\"name\":\"exception " << event.contractId_ << "\",\"cat\":\"work_contract\",\"ph\":\"i\",\"s\":\"t\"";
+                break;
+        }
+        stream << ",\"ts\":" << timeStamp << ",\"pid\":1,\"tid\":" << event.thread_ << ",\"args\":{\"contract\":" << event.contractId_ << "}}";
+    }
+    stream << "\n]}\n";
+    stream.flags(flags);
+}
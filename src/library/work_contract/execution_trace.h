@@ -0,0 +1,125 @@
+#pragma once
+
+#include "./time_stamp_counter.h"
+#include "./work_contract_id.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <span>
+#include <vector>
+
+
+namespace bcpp
+{
+
+    enum class trace_event_type : std::uint8_t
+    {
+        schedule,
+        start,
+        end,
+        release,
+        exception
+    };
+
+
+    //=========================================================================
+    // one traced event.  time is in time stamp counter ticks.  thread is the index
+    // of the recording thread amongst the threads which have used the group.
+    // contract ids do not include the generation.
+    struct trace_event
+    {
+        std::uint64_t                   time_;
+        implementation::work_contract_id contractId_;
+        trace_event_type                type_;
+        std::uint32_t                   thread_;
+    };
+
+
+    // write events as chrome trace event format json (chrome://tracing, ui.perfetto.dev).
+    // each contract execution is a slice on its thread's track.  schedules, releases
+    // and exceptions are instant events.
+    void write_chrome_trace
+    (
+        std::ostream &,
+        std::span<trace_event const>
+    );
+
+} // namespace bcpp
+
+
+namespace bcpp::implementation
+{
+
+    // execution tracing is selected at compile time (cmake -DWORK_CONTRACT_TRACING=ON).
+    // when disabled none of the tracing code or storage is present.
+    #if defined(WORK_CONTRACT_TRACING)
+        static bool constexpr tracing_enabled = true;
+    #else
+        static bool constexpr tracing_enabled = false;
+    #endif
+
+
+    //=========================================================================
+    // a ring of the most recent trace_buffer_capacity events recorded by one thread.
+    // the single writer never blocks (older events are overwritten).  readers copy
+    // the ring and then discard any events which were overwritten while copying.
+    class trace_buffer
+    {
+    public:
+
+        static auto constexpr capacity = (1ull << 16);
+
+        trace_buffer();
+
+        void record
+        (
+            trace_event_type,
+            work_contract_id
+        ) noexcept;
+
+        void copy_to
+        (
+            std::vector<trace_event> &,
+            std::uint32_t
+        ) const;
+
+    private:
+
+        static auto constexpr type_shift = 56;
+        // index and band (see work_contract_id.h)
+        static auto constexpr contract_id_mask = ((1ull << 38) - 1);
+
+        struct entry
+        {
+            std::uint64_t   time_;
+            // contract id (without generation) and event type (in the top byte)
+            std::uint64_t   value_;
+        };
+
+        std::unique_ptr<entry[]>                entries_;
+
+        std::uint64_t                           head_{0};
+
+    }; // class trace_buffer
+
+} // namespace bcpp::implementation
+
+
+//=============================================================================
+inline void bcpp::implementation::trace_buffer::record
+(
+    trace_event_type type,
+    work_contract_id contractId
+) noexcept
+{
+    // the fence orders the previous event's head update before this event's writes so
+    // that a reader which sees this event overwrite a slot also sees the head which
+    // tells it that the slot was overwritten
+    std::atomic_thread_fence(std::memory_order_release);
+    auto & entry = entries_[head_ & (capacity - 1)];
+    std::atomic_ref(entry.time_).store(read_tsc(), std::memory_order_relaxed);
+    std::atomic_ref(entry.value_).store((contractId & contract_id_mask) | (static_cast<std::uint64_t>(type) << type_shift), std::memory_order_relaxed);
+    std::atomic_ref(head_).store(head_ + 1, std::memory_order_release);
+}
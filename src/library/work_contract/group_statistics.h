@@ -0,0 +1,103 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+
+namespace bcpp::implementation
+{
+
+    // runtime statistics are selected at compile time (cmake -DWORK_CONTRACT_STATISTICS=ON).
+    // when disabled none of the counting code is present.
+    #if defined(WORK_CONTRACT_STATISTICS)
+        static bool constexpr statistics_enabled = true;
+    #else
+        static bool constexpr statistics_enabled = false;
+    #endif
+
+
+    enum class statistics_counter : std::uint64_t
+    {
+        executions,
+        empty_polls,
+        releases,
+        exceptions,
+        schedule_calls,
+        signals_set,
+        selects,
+        subtrees_scanned,
+        select_retries,
+        contracts_created,
+        count
+    };
+
+
+    //=========================================================================
+    // one thread's counters for one group.  each thread's counters occupy their own
+    // cache lines and have a single writer which updates them without read-modify-write
+    // operations.  any thread may read them at any time.
+    class alignas(64) statistics_counters
+    {
+    public:
+
+        void increment
+        (
+            statistics_counter counter,
+            std::uint64_t value = 1
+        ) noexcept
+        {
+            auto & target = counters_[static_cast<std::uint64_t>(counter)];
+            std::atomic_ref(target).store(target + value, std::memory_order_relaxed);
+        }
+
+        std::uint64_t load
+        (
+            statistics_counter counter
+        ) const noexcept
+        {
+            return std::atomic_ref(const_cast<std::uint64_t &>(counters_[static_cast<std::uint64_t>(counter)])).load(std::memory_order_relaxed);
+        }
+
+    private:
+
+        std::array<std::uint64_t, static_cast<std::uint64_t>(statistics_counter::count)> counters_{};
+
+    }; // class statistics_counters
+
+} // namespace bcpp::implementation
+
+
+namespace bcpp
+{
+
+    //=========================================================================
+    // a snapshot of a group's statistics, summed over every thread which has used
+    // the group.  counters are cumulative since the group was constructed.
+    struct group_statistics
+    {
+        std::uint64_t   executions_{0};             // work functions invoked
+        std::uint64_t   emptyPolls_{0};             // execute calls which found no scheduled contract
+        std::uint64_t   releases_{0};               // release functions invoked (contracts erased)
+        std::uint64_t   exceptions_{0};             // exceptions thrown by work or release functions
+        std::uint64_t   scheduleCalls_{0};          // calls to schedule (including this_contract::schedule)
+        std::uint64_t   signalsSet_{0};             // signals set in the signal trees
+        std::uint64_t   selects_{0};                // searches of a band for a scheduled contract
+        std::uint64_t   subTreesScanned_{0};        // signal trees visited by those searches
+        std::uint64_t   selectRetries_{0};          // failed signal tree updates during selection
+        std::uint64_t   liveContracts_{0};          // contracts created and not yet erased
+        std::uint64_t   scheduledContracts_{0};     // contracts with a pending schedule
+
+        // schedule calls per signal set.  above 1 when schedules coalesce.
+        double coalescing_ratio() const noexcept
+        {
+            return (signalsSet_ == 0) ? 0.0 : (static_cast<double>(scheduleCalls_) / signalsSet_);
+        }
+
+        double subtrees_per_select() const noexcept
+        {
+            return (selects_ == 0) ? 0.0 : (static_cast<double>(subTreesScanned_) / selects_);
+        }
+    };
+
+} // namespace bcpp
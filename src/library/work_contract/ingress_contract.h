@@ -0,0 +1,369 @@
+#pragma once
+
+#include "./work_contract.h"
+#include "./work_contract_this.h"
+
+#include <include/synchronization_mode.h>
+#include <include/non_copyable.h>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+
+namespace bcpp
+{
+
+    enum class producer_model
+    {
+        single,
+        multiple
+    };
+
+
+    struct ingress_configuration
+    {
+        // rounded up to a power of two
+        std::size_t     capacity_{1024};
+        // the maximum number of items handed to the callback per execution
+        std::size_t     maxBatchSize_{64};
+    };
+
+} // namespace bcpp
+
+
+namespace bcpp::implementation
+{
+
+    //=========================================================================
+    // a work contract which owns a bounded ring of items.  producers push items
+    // and the contract's callback is handed a span of (up to maxBatchSize_) items
+    // per execution.  a single atomic count of pending items both publishes items
+    // to the consumer and detects the empty to non empty transition so only the
+    // push which finds the ring empty schedules the contract.  the contract
+    // reschedules itself for as long as items remain.  a batch never wraps
+    // the end of the ring (the remainder is handed over by the next execution).
+    // with producer_model::multiple, producers reserve slots with a cas and publish
+    // them with a per slot sequence (the consumer stops at the first unpublished slot).
+    // the ring is shared with the contract's work so it outlives an execution which
+    // is still in progress when the ingress_contract is destroyed.
+    template <synchronization_mode T, typename V, producer_model P = producer_model::single>
+    requires (std::default_initializable<V> && std::movable<V>)
+    class ingress_contract :
+        non_copyable
+    {
+    public:
+
+        static auto constexpr mode = T;
+        static auto constexpr producers = P;
+        using value_type = V;
+        using work_contract_group_type = work_contract_group<mode>;
+        using work_contract_type = work_contract<mode>;
+
+        ingress_contract() = default;
+
+        ingress_contract
+        (
+            work_contract_group_type &,
+            ingress_configuration,
+            std::invocable<std::span<value_type>> auto &&
+        );
+
+        ingress_contract
+        (
+            work_contract_group_type &,
+            ingress_configuration,
+            std::invocable<std::span<value_type>> auto &&,
+            std::invocable auto &&
+        );
+
+        ingress_contract(ingress_contract &&) = default;
+        ingress_contract & operator = (ingress_contract &&) = default;
+
+        ~ingress_contract() = default;
+
+        template <typename U>
+        requires std::assignable_from<value_type &, U &&>
+        bool try_push
+        (
+            U &&
+        );
+
+        bool release();
+
+        bool is_valid() const;
+
+        std::size_t capacity() const noexcept;
+
+        work_contract_type const & get_contract() const noexcept{return contract_;}
+
+    private:
+
+        struct ring
+        {
+            ring
+            (
+                ingress_configuration
+            );
+
+            alignas(64) std::atomic<std::size_t>            pending_{0};
+
+            // producer side
+            alignas(64) std::size_t                         tail_{0};                   // producer_model::single
+            std::atomic<std::size_t>                        enqueuePosition_{0};        // producer_model::multiple
+
+            // consumer side
+            alignas(64) std::size_t                         head_{0};
+            std::size_t const                               capacity_;
+            std::size_t const                               mask_;
+            std::size_t const                               maxBatchSize_;
+            std::unique_ptr<value_type[]>                   values_;
+            std::unique_ptr<std::atomic<std::size_t>[]>     sequences_;                 // producer_model::multiple
+        };
+
+        // the ring is shared with the contract's work so that it outlives any execution
+        // which is in progress when the ingress_contract is destroyed
+        template <typename F>
+        struct consumer_ring :
+            ring
+        {
+            consumer_ring(ingress_configuration configuration, F callback):ring(configuration), callback_(std::move(callback)){}
+
+            F   callback_;
+        };
+
+        // completes the batch (even if the callback throws)
+        class auto_complete_batch;
+
+        template <typename F>
+        static auto make_work
+        (
+            std::shared_ptr<consumer_ring<F>>
+        );
+
+        std::shared_ptr<ring>                               ring_;
+
+        work_contract_type                                  contract_;
+
+    }; // class ingress_contract
+
+} // namespace bcpp::implementation
+
+
+namespace bcpp
+{
+
+    template <typename V, producer_model P = producer_model::single>
+    using ingress_contract = implementation::ingress_contract<synchronization_mode::non_blocking, V, P>;
+
+    template <typename V, producer_model P = producer_model::single>
+    using blocking_ingress_contract = implementation::ingress_contract<synchronization_mode::blocking, V, P>;
+
+} // namespace bcpp
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T, typename V, bcpp::producer_model P>
+requires (std::default_initializable<V> && std::movable<V>)
+class bcpp::implementation::ingress_contract<T, V, P>::auto_complete_batch
+{
+public:
+
+    auto_complete_batch
+    (
+        ring & target,
+        std::size_t batchSize
+    ) noexcept :
+        ring_(target),
+        batchSize_(batchSize)
+    {
+    }
+
+    ~auto_complete_batch()
+    {
+        auto & ring = ring_;
+        if constexpr (producers == producer_model::multiple)
+            for (auto i = ring.head_; i < ring.head_ + batchSize_; ++i)
+                ring.sequences_[i & ring.mask_].store(i + ring.capacity_, std::memory_order_release);
+        ring.head_ += batchSize_;
+        if (ring.pending_.fetch_sub(batchSize_, std::memory_order_acq_rel) != batchSize_)
+            this_contract::schedule();
+    }
+
+private:
+
+    ring &          ring_;
+    std::size_t     batchSize_;
+};
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T, typename V, bcpp::producer_model P>
+requires (std::default_initializable<V> && std::movable<V>)
+inline bcpp::implementation::ingress_contract<T, V, P>::ring::ring
+(
+    ingress_configuration configuration
+):
+    capacity_(std::bit_ceil(std::max<std::size_t>(configuration.capacity_, 1))),
+    mask_(capacity_ - 1),
+    maxBatchSize_(std::max<std::size_t>(configuration.maxBatchSize_, 1)),
+    values_(std::make_unique<value_type[]>(capacity_))
+{
+    if constexpr (producers == producer_model::multiple)
+    {
+        sequences_ = std::make_unique<std::atomic<std::size_t>[]>(capacity_);
+        for (auto i = 0ull; i < capacity_; ++i)
+            sequences_[i].store(i, std::memory_order_relaxed);
+    }
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T, typename V, bcpp::producer_model P>
+requires (std::default_initializable<V> && std::movable<V>)
+inline bcpp::implementation::ingress_contract<T, V, P>::ingress_contract
+(
+    work_contract_group_type & workContractGroup,
+    ingress_configuration configuration,
+    std::invocable<std::span<value_type>> auto && callback
+)
+{
+    using callback_type = std::decay_t<decltype(callback)>;
+    auto consumer = std::make_shared<consumer_ring<callback_type>>(configuration, std::forward<decltype(callback)>(callback));
+    ring_ = consumer;
+    contract_ = workContractGroup.create_contract(make_work(std::move(consumer)));
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T, typename V, bcpp::producer_model P>
+requires (std::default_initializable<V> && std::movable<V>)
+inline bcpp::implementation::ingress_contract<T, V, P>::ingress_contract
+(
+    work_contract_group_type & workContractGroup,
+    ingress_configuration configuration,
+    std::invocable<std::span<value_type>> auto && callback,
+    std::invocable auto && releaseFunction
+)
+{
+    using callback_type = std::decay_t<decltype(callback)>;
+    auto consumer = std::make_shared<consumer_ring<callback_type>>(configuration, std::forward<decltype(callback)>(callback));
+    ring_ = consumer;
+    contract_ = workContractGroup.create_contract(make_work(std::move(consumer)), 
+            std::forward<std::decay_t<decltype(releaseFunction)>>(releaseFunction));
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T, typename V, bcpp::producer_model P>
+requires (std::default_initializable<V> && std::movable<V>)
+template <typename F>
+inline auto bcpp::implementation::ingress_contract<T, V, P>::make_work
+(
+    // the contract's work: hand the next batch of published items to the callback
+    std::shared_ptr<consumer_ring<F>> consumer
+)
+{
+    return [consumer = std::move(consumer)]()
+            {
+                auto & ring = *consumer;
+                auto index = (ring.head_ & ring.mask_);
+                auto batchSize = std::min({ring.pending_.load(std::memory_order_acquire), ring.maxBatchSize_, ring.capacity_ - index});
+                if constexpr (producers == producer_model::multiple)
+                {
+                    auto published = 0ull;
+                    while ((published < batchSize) && (ring.sequences_[(index + published)].load(std::memory_order_acquire) == (ring.head_ + published + 1)))
+                        ++published;
+                    batchSize = published;
+                }
+                auto_complete_batch autoCompleteBatch(ring, batchSize);
+                if (batchSize > 0)
+                    consumer->callback_(std::span<value_type>(ring.values_.get() + index, batchSize));
+            };
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T, typename V, bcpp::producer_model P>
+requires (std::default_initializable<V> && std::movable<V>)
+template <typename U>
+requires std::assignable_from<V &, U &&>
+inline bool bcpp::implementation::ingress_contract<T, V, P>::try_push
+(
+    // returns false if the ring is full
+    U && value
+)
+{
+    auto & ring = *ring_;
+    if constexpr (producers == producer_model::single)
+    {
+        if (ring.pending_.load(std::memory_order_acquire) >= ring.capacity_)
+            return false;
+        ring.values_[ring.tail_++ & ring.mask_] = std::forward<U>(value);
+    }
+    else
+    {
+        auto position = ring.enqueuePosition_.load(std::memory_order_relaxed);
+        while (true)
+        {
+            auto sequence = ring.sequences_[position & ring.mask_].load(std::memory_order_acquire);
+            if (auto difference = static_cast<std::int64_t>(sequence - position); difference == 0)
+            {
+                if (ring.enqueuePosition_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (difference < 0)
+            {
+                return false;
+            }
+            else
+            {
+                position = ring.enqueuePosition_.load(std::memory_order_relaxed);
+            }
+        }
+        ring.values_[position & ring.mask_] = std::forward<U>(value);
+        ring.sequences_[position & ring.mask_].store(position + 1, std::memory_order_release);
+    }
+    if (ring.pending_.fetch_add(1, std::memory_order_acq_rel) == 0)
+        contract_.schedule();
+    return true;
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T, typename V, bcpp::producer_model P>
+requires (std::default_initializable<V> && std::movable<V>)
+inline bool bcpp::implementation::ingress_contract<T, V, P>::release
+(
+)
+{
+    return contract_.release();
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T, typename V, bcpp::producer_model P>
+requires (std::default_initializable<V> && std::movable<V>)
+inline bool bcpp::implementation::ingress_contract<T, V, P>::is_valid
+(
+) const
+{
+    return contract_.is_valid();
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T, typename V, bcpp::producer_model P>
+requires (std::default_initializable<V> && std::movable<V>)
+inline std::size_t bcpp::implementation::ingress_contract<T, V, P>::capacity
+(
+) const noexcept
+{
+    return ring_->capacity_;
+}
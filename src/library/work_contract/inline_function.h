@@ -0,0 +1,145 @@
+#pragma once
+
+#include <include/non_copyable.h>
+#include <include/non_movable.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+namespace bcpp
+{
+
+    //=========================================================================
+    // fixed size, non allocating callable storage.  the callable is constructed 
+    // directly within the object and sizeof(inline_function<R(A...), N>) == N.
+    // callables which are too large (or over aligned) fail to compile.  these 
+    // can be explicitly moved to the heap with bcpp::make_heap_callable().
+    template <typename, std::size_t>
+    class inline_function;
+
+
+    template <typename R, typename ... Args, std::size_t N>
+    class inline_function<R(Args ...), N> final :
+        non_copyable,
+        non_movable
+    {
+    public:
+
+        static auto constexpr capacity = (N - sizeof(void *) - sizeof(void *));
+        static auto constexpr alignment = alignof(void *);
+
+        template <typename F>
+        static auto constexpr fits = ((sizeof(F) <= capacity) && (alignof(F) <= alignment));
+
+        inline_function() = default;
+
+        ~inline_function(){reset();}
+
+        template <typename F>
+        requires (!std::is_same_v<std::decay_t<F>, inline_function>)
+        inline_function & operator =
+        (
+            F && callable
+        )
+        {
+            using callable_type = std::decay_t<F>;
+            static_assert(fits<callable_type>, "callable is too large to be stored inline within a work contract. " 
+                    "reduce the size of its captures or explicitly wrap it with bcpp::make_heap_callable()");
+            reset();
+            ::new (static_cast<void *>(buffer_)) callable_type(std::forward<F>(callable));
+            invoke_ = [](void * callable, Args && ... args) -> R
+                    {
+                        return (*std::launder(reinterpret_cast<callable_type *>(callable)))(std::forward<Args>(args) ...);
+                    };
+            if constexpr (std::is_trivially_destructible_v<callable_type>)
+                destroy_ = nullptr;
+            else
+                destroy_ = [](void * callable) noexcept {std::launder(reinterpret_cast<callable_type *>(callable))->~callable_type();};
+            return *this;
+        }
+
+        inline_function & operator =
+        (
+            std::nullptr_t
+        ) noexcept
+        {
+            reset();
+            return *this;
+        }
+
+        R operator()
+        (
+            Args ... args
+        )
+        {
+            return invoke_(buffer_, std::forward<Args>(args) ...);
+        }
+
+        explicit operator bool() const noexcept{return (invoke_ != nullptr);}
+
+    private:
+
+        void reset() noexcept
+        {
+            if (destroy_)
+                destroy_(buffer_);
+            invoke_ = nullptr;
+            destroy_ = nullptr;
+        }
+
+        R (* invoke_)(void *, Args && ...){nullptr};
+
+        void (* destroy_)(void *) noexcept {nullptr};
+
+        alignas(alignment) std::byte buffer_[capacity];
+
+    }; // class inline_function
+
+
+    //=========================================================================
+    // explicit fallback for callables which do not fit within an inline_function.
+    // the callable is moved to the heap and only the pointer is stored inline.
+    template <typename F>
+    class heap_callable
+    {
+    public:
+
+        explicit heap_callable
+        (
+            F callable
+        ):
+            callable_(std::make_unique<F>(std::move(callable)))
+        {
+        }
+
+        decltype(auto) operator()
+        (
+            auto && ... args
+        )
+        {
+            return (*callable_)(std::forward<decltype(args)>(args) ...);
+        }
+
+    private:
+
+        std::unique_ptr<F> callable_;
+
+    }; // class heap_callable
+
+
+    //=========================================================================
+    template <typename F>
+    static auto make_heap_callable
+    (
+        F && callable
+    ) -> heap_callable<std::decay_t<F>>
+    {
+        return heap_callable<std::decay_t<F>>(std::forward<F>(callable));
+    }
+
+} // namespace bcpp
@@ -0,0 +1,117 @@
+#include "./latency_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+//=============================================================================
+bcpp::latency_histogram::latency_histogram
+(
+    latency_histogram const & other
+) noexcept
+{
+    merge(other);
+}
+
+
+//=============================================================================
+auto bcpp::latency_histogram::operator =
+(
+    latency_histogram const & other
+) noexcept -> latency_histogram &
+{
+    if (this != &other)
+    {
+        reset();
+        merge(other);
+    }
+    return *this;
+}
+
+
+//=============================================================================
+void bcpp::latency_histogram::merge
+(
+    // (this histogram's writer or while there is no writer)
+    latency_histogram const & other
+) noexcept
+{
+    for (auto i = 0ull; i < bucket_count; ++i)
+        if (auto value = load(other.buckets_[i]); value != 0)
+            store(buckets_[i], buckets_[i] + value);
+    store(count_, count_ + load(other.count_));
+    store(sum_, sum_ + load(other.sum_));
+    store(max_, std::max(max_, load(other.max_)));
+}
+
+
+//=============================================================================
+void bcpp::latency_histogram::reset
+(
+    // samples recorded concurrently with a reset may be lost
+) noexcept
+{
+    for (auto & bucket : buckets_)
+        store(bucket, 0);
+    store(count_, 0);
+    store(sum_, 0);
+    store(max_, 0);
+}
+
+
+//=============================================================================
+std::uint64_t bcpp::latency_histogram::count
+(
+) const noexcept
+{
+    return load(count_);
+}
+
+
+//=============================================================================
+std::chrono::nanoseconds bcpp::latency_histogram::percentile
+(
+    double fraction
+) const noexcept
+{
+    auto total = 0ull;
+    for (auto const & bucket : buckets_)
+        total += load(bucket);
+    if (total == 0)
+        return std::chrono::nanoseconds(0);
+    auto target = static_cast<std::uint64_t>(std::ceil(std::clamp(fraction, 0.0, 1.0) * total));
+    auto seen = 0ull;
+    for (auto i = 0ull; i < bucket_count; ++i)
+        if ((seen += load(buckets_[i])) >= std::max<std::uint64_t>(target, 1))
+            return to_nanoseconds(std::min(bucket_value(i + 1) - 1, load(max_)));
+    return max();
+}
+
+
+//=============================================================================
+std::chrono::nanoseconds bcpp::latency_histogram::mean
+(
+) const noexcept
+{
+    auto samples = load(count_);
+    return (samples == 0) ? std::chrono::nanoseconds(0) : to_nanoseconds(load(sum_) / samples);
+}
+
+
+//=============================================================================
+std::chrono::nanoseconds bcpp::latency_histogram::max
+(
+) const noexcept
+{
+    return to_nanoseconds(load(max_));
+}
+
+
+//=============================================================================
+std::chrono::nanoseconds bcpp::latency_histogram::to_nanoseconds
+(
+    std::uint64_t ticks
+) noexcept
+{
+    return std::chrono::nanoseconds(static_cast<std::int64_t>(ticks / implementation::tsc_ticks_per_nanosecond()));
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+#include "./time_stamp_counter.h"
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+
+
+namespace bcpp::implementation
+{
+
+    // schedule to execute latency instrumentation is selected at compile time
+    // (cmake -DWORK_CONTRACT_LATENCY_INSTRUMENTATION=ON).  when disabled none of
+    // the instrumentation code or storage is present.
+    #if defined(WORK_CONTRACT_LATENCY_INSTRUMENTATION)
+        static bool constexpr latency_instrumentation_enabled = true;
+    #else
+        static bool constexpr latency_instrumentation_enabled = false;
+    #endif
+
+} // namespace bcpp::implementation
+
+
+namespace bcpp
+{
+
+    //=========================================================================
+    // a log linear histogram of durations (in time stamp counter ticks) with 16
+    // sub buckets per power of two (a resolution of 1/16th of the value).  each
+    // histogram has a single writer which updates it without read-modify-write
+    // operations.  any thread may take a copy of it (or merge it into another) at
+    // any time.
+    class latency_histogram
+    {
+    public:
+
+        static auto constexpr sub_bucket_bits = 4;
+        static auto constexpr sub_bucket_count = (1ull << sub_bucket_bits);
+        static auto constexpr bucket_count = ((64 - sub_bucket_bits + 1) * sub_bucket_count);
+
+        latency_histogram() = default;
+
+        latency_histogram(latency_histogram const &) noexcept;
+        latency_histogram & operator = (latency_histogram const &) noexcept;
+
+        // single writer only
+        void record
+        (
+            std::uint64_t
+        ) noexcept;
+
+        void merge
+        (
+            latency_histogram const &
+        ) noexcept;
+
+        void reset() noexcept;
+
+        std::uint64_t count() const noexcept;
+
+        // the value below which the specified fraction (0.0 to 1.0) of samples fall
+        std::chrono::nanoseconds percentile
+        (
+            double
+        ) const noexcept;
+
+        std::chrono::nanoseconds mean() const noexcept;
+
+        std::chrono::nanoseconds max() const noexcept;
+
+        static std::uint64_t bucket_index
+        (
+            std::uint64_t
+        ) noexcept;
+
+        static std::uint64_t bucket_value
+        (
+            std::uint64_t
+        ) noexcept;
+
+    private:
+
+        static std::chrono::nanoseconds to_nanoseconds
+        (
+            std::uint64_t
+        ) noexcept;
+
+        static std::uint64_t load(std::uint64_t const & value) noexcept{return std::atomic_ref(const_cast<std::uint64_t &>(value)).load(std::memory_order_relaxed);}
+
+        static void store(std::uint64_t & target, std::uint64_t value) noexcept{std::atomic_ref(target).store(value, std::memory_order_relaxed);}
+
+        std::array<std::uint64_t, bucket_count>                 buckets_{};
+        std::uint64_t                                           count_{0};
+        std::uint64_t                                           sum_{0};
+        std::uint64_t                                           max_{0};
+
+    }; // class latency_histogram
+
+} // namespace bcpp
+
+
+//=============================================================================
+inline std::uint64_t bcpp::latency_histogram::bucket_index
+(
+    // values below sub_bucket_count have a bucket each.  above that each power
+    // of two is divided into sub_bucket_count buckets.
+    std::uint64_t value
+) noexcept
+{
+    if (value < sub_bucket_count)
+        return value;
+    auto msb = static_cast<std::uint64_t>(std::bit_width(value) - 1);
+    return (((msb - sub_bucket_bits + 1) << sub_bucket_bits) | ((value >> (msb - sub_bucket_bits)) & (sub_bucket_count - 1)));
+}
+
+
+//=============================================================================
+inline std::uint64_t bcpp::latency_histogram::bucket_value
+(
+    // the lowest value which falls into the bucket
+    std::uint64_t index
+) noexcept
+{
+    if (index < sub_bucket_count)
+        return index;
+    auto msb = ((index >> sub_bucket_bits) + sub_bucket_bits - 1);
+    return ((sub_bucket_count | (index & (sub_bucket_count - 1))) << (msb - sub_bucket_bits));
+}
+
+
+//=============================================================================
+inline void bcpp::latency_histogram::record
+(
+    std::uint64_t ticks
+) noexcept
+{
+    auto & bucket = buckets_[bucket_index(ticks)];
+    store(bucket, bucket + 1);
+    store(count_, count_ + 1);
+    store(sum_, sum_ + ticks);
+    if (ticks > max_)
+        store(max_, ticks);
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+
+
+namespace bcpp
+{
+
+    // contracts created with max_concurrency{n} may be executed by up to n threads
+    // at once (n is clamped to [1, 255]).  intended for contracts which front a work 
+    // source which is safe to drain concurrently (an mpmc queue for instance).  each 
+    // schedule() of an executing parallel contract admits one more concurrent execution.
+    // the release and exception functions of a parallel contract may be invoked
+    // concurrently with its other executions.
+    enum class max_concurrency : std::uint64_t {};
+
+} // namespace bcpp
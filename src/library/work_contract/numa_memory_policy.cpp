@@ -0,0 +1,40 @@
+#include "./numa_memory_policy.h"
+
+#if defined(__linux__)
+    #include <linux/mempolicy.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+
+//=============================================================================
+bcpp::implementation::scoped_numa_memory_policy::scoped_numa_memory_policy
+(
+    std::uint32_t numaNode,
+    std::uint32_t numaNodeCount
+)
+{
+    #if defined(__linux__)
+        if ((numaNodeCount <= 1) || (numaNode >= max_numa_nodes))
+            return;
+        // the kernel treats maxnode as one more than the number of bits in the mask
+        if (::syscall(SYS_get_mempolicy, &previousMode_, previousNodeMask_.data(), max_numa_nodes + 1, nullptr, 0) != 0)
+            return;
+        node_mask nodeMask{};
+        nodeMask[numaNode / (8 * sizeof(unsigned long))] = (1ul << (numaNode % (8 * sizeof(unsigned long))));
+        active_ = (::syscall(SYS_set_mempolicy, MPOL_PREFERRED, nodeMask.data(), max_numa_nodes + 1) == 0);
+    #endif
+}
+
+
+//=============================================================================
+bcpp::implementation::scoped_numa_memory_policy::~scoped_numa_memory_policy
+(
+)
+{
+    #if defined(__linux__)
+        if (active_)
+            ::syscall(SYS_set_mempolicy, previousMode_, (previousMode_ == MPOL_DEFAULT) ? nullptr : previousNodeMask_.data(),
+                    (previousMode_ == MPOL_DEFAULT) ? 0 : (max_numa_nodes + 1));
+    #endif
+}
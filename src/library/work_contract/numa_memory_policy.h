@@ -0,0 +1,43 @@
+#pragma once
+
+#include <include/non_copyable.h>
+#include <include/non_movable.h>
+
+#include <cstdint>
+#include <array>
+
+
+namespace bcpp::implementation
+{
+
+    //=========================================================================
+    // while in scope, memory first touched by the calling thread is preferentially
+    // allocated on the specified numa node.  restores the thread's previous memory
+    // policy on destruction.  does nothing on single node systems (or where the
+    // memory policy syscalls are unavailable).
+    class scoped_numa_memory_policy :
+        non_copyable,
+        non_movable
+    {
+    public:
+
+        scoped_numa_memory_policy
+        (
+            std::uint32_t,
+            std::uint32_t
+        );
+
+        ~scoped_numa_memory_policy();
+
+    private:
+
+        static auto constexpr max_numa_nodes = 1024;
+        using node_mask = std::array<unsigned long, max_numa_nodes / (8 * sizeof(unsigned long))>;
+
+        bool        active_{false};
+        int         previousMode_{0};
+        node_mask   previousNodeMask_{};
+
+    }; // class scoped_numa_memory_policy
+
+} // namespace bcpp::implementation
@@ -0,0 +1,87 @@
+#include "./numa_work_contract_group.h"
+#include "./cpu_topology.h"
+
+#include <algorithm>
+
+#include <sched.h>
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+bcpp::implementation::numa_work_contract_group<T>::numa_work_contract_group
+(
+):
+    numa_work_contract_group(work_contract_group_type::default_capacity)
+{
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+bcpp::implementation::numa_work_contract_group<T>::numa_work_contract_group
+(
+    // capacity is the initial capacity of each node's partition
+    std::uint64_t capacity
+)
+{
+    cpu_topology cpuTopology;
+    auto nodeCount = cpuTopology.numa_node_count();
+    for (auto const & logicalCpu : cpuTopology.logical_cpus())
+    {
+        if (logicalCpu.id_ >= cpuToNode_.size())
+            cpuToNode_.resize(logicalCpu.id_ + 1, 0);
+        cpuToNode_[logicalCpu.id_] = logicalCpu.numaNode_;
+    }
+
+    // each partition (the group object, its signal trees and contract storage)
+    // is allocated while the memory policy prefers the partition's node
+    partitions_.resize(nodeCount);
+    for (auto node = 0u; node < nodeCount; ++node)
+    {
+        scoped_numa_memory_policy memoryPolicy(node, nodeCount);
+        partitions_[node] = std::make_unique<work_contract_group_type>(capacity);
+    }
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+bcpp::implementation::numa_work_contract_group<T>::~numa_work_contract_group
+(
+)
+{
+    stop();
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+void bcpp::implementation::numa_work_contract_group<T>::stop
+(
+)
+{
+    for (auto & partition : partitions_)
+        partition->stop();
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+auto bcpp::implementation::numa_work_contract_group<T>::current_node
+(
+    // the numa node of the cpu on which the calling thread is currently running
+) const -> numa_node
+{
+    auto cpu = sched_getcpu();
+    if ((cpu < 0) || (static_cast<std::size_t>(cpu) >= cpuToNode_.size()))
+        return numa_node{0};
+    return numa_node{std::min<std::uint32_t>(cpuToNode_[cpu], partitions_.size() - 1)};
+}
+
+
+//=============================================================================
+namespace bcpp::implementation
+{
+    template class numa_work_contract_group<synchronization_mode::blocking>;
+    template class numa_work_contract_group<synchronization_mode::non_blocking>;
+}
@@ -0,0 +1,205 @@
+#pragma once
+
+#include "./work_contract.h"
+#include "./numa_memory_policy.h"
+
+#include <include/synchronization_mode.h>
+#include <include/non_movable.h>
+#include <include/non_copyable.h>
+
+#include <cstdint>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+
+namespace bcpp
+{
+
+    // the numa node on which a contract (its signal tree and storage) is placed
+    enum class numa_node : std::uint32_t {};
+
+} // namespace bcpp
+
+
+namespace bcpp::implementation
+{
+
+    //=========================================================================
+    // a work_contract_group partitioned by numa node.  each node has its own group
+    // (signal trees and contract storage) which is allocated, and grown, with a
+    // memory policy which prefers that node.  workers select from the partition of
+    // the node on which they run before stealing from the other partitions.
+    // contracts are ordinary work_contracts of the partition in which they are created.
+    // workers should be pinned (the home node of a thread is determined on its first
+    // call to execute_next_contract).
+    template <synchronization_mode T>
+    class numa_work_contract_group :
+        non_copyable,
+        non_movable
+    {
+    public:
+
+        static auto constexpr mode = T;
+        using work_contract_group_type = work_contract_group<mode>;
+        using work_contract_type = work_contract<mode>;
+
+        numa_work_contract_group();
+
+        numa_work_contract_group
+        (
+            std::uint64_t
+        );
+
+        ~numa_work_contract_group();
+
+        // create a contract on the specified node.  arguments are as per
+        // work_contract_group::create_contract.
+        template <typename ... Args>
+        work_contract_type create_contract
+        (
+            numa_node,
+            Args && ...
+        );
+
+        // create a contract on the node of the calling thread
+        template <typename ... Args>
+        work_contract_type create_contract
+        (
+            Args && ...
+        );
+
+        std::uint64_t execute_next_contract();
+
+        void stop();
+
+        std::uint32_t node_count() const;
+
+        numa_node current_node() const;
+
+        work_contract_group_type & get_partition
+        (
+            numa_node
+        );
+
+    private:
+
+        // in blocking mode, how long a worker waits on its own partition before
+        // checking the remote partitions
+        static auto constexpr steal_interval = std::chrono::milliseconds(1);
+
+        std::uint32_t get_home_node();
+
+        std::vector<std::uint32_t>                                  cpuToNode_;
+
+        std::vector<std::unique_ptr<work_contract_group_type>>      partitions_;
+
+        static std::uint32_t thread_local                           tls_homeNode_;
+
+    }; // class numa_work_contract_group
+
+
+    template <synchronization_mode T>
+    std::uint32_t thread_local numa_work_contract_group<T>::tls_homeNode_ = ~0u;
+
+} // namespace bcpp::implementation
+
+
+namespace bcpp
+{
+    //=========================================================================
+    using blocking_numa_work_contract_group = implementation::numa_work_contract_group<synchronization_mode::blocking>;
+    using numa_work_contract_group = implementation::numa_work_contract_group<synchronization_mode::non_blocking>;
+
+} // namespace bcpp
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+template <typename ... Args>
+inline auto bcpp::implementation::numa_work_contract_group<T>::create_contract
+(
+    // growth of the partition (if any) allocates on the partition's node
+    numa_node numaNode,
+    Args && ... args
+) -> work_contract_type
+{
+    auto nodeIndex = (static_cast<std::uint32_t>(numaNode) % partitions_.size());
+    scoped_numa_memory_policy memoryPolicy(nodeIndex, partitions_.size());
+    return partitions_[nodeIndex]->create_contract(std::forward<Args>(args) ...);
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+template <typename ... Args>
+inline auto bcpp::implementation::numa_work_contract_group<T>::create_contract
+(
+    Args && ... args
+) -> work_contract_type
+{
+    return create_contract(current_node(), std::forward<Args>(args) ...);
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline std::uint64_t bcpp::implementation::numa_work_contract_group<T>::execute_next_contract
+(
+    // select from the partition of this thread's node first.  only if it has no
+    // scheduled contracts are the other partitions (nearest node id first) tried.
+)
+{
+    auto homeNode = get_home_node();
+    auto partitionCount = partitions_.size();
+    if constexpr (mode == synchronization_mode::blocking)
+    {
+        if (auto contractId = partitions_[homeNode]->execute_next_contract(steal_interval); contractId != ~0ull)
+            return contractId;
+        for (auto i = 1ull; i < partitionCount; ++i)
+            if (auto contractId = partitions_[(homeNode + i) % partitionCount]->execute_next_contract(std::chrono::nanoseconds(0)); contractId != ~0ull)
+                return contractId;
+    }
+    else
+    {
+        if (auto contractId = partitions_[homeNode]->execute_next_contract(); contractId != ~0ull)
+            return contractId;
+        for (auto i = 1ull; i < partitionCount; ++i)
+            if (auto contractId = partitions_[(homeNode + i) % partitionCount]->execute_next_contract(); contractId != ~0ull)
+                return contractId;
+    }
+    return ~0ull;
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline std::uint32_t bcpp::implementation::numa_work_contract_group<T>::get_home_node
+(
+)
+{
+    if (tls_homeNode_ == ~0u) [[unlikely]]
+        tls_homeNode_ = static_cast<std::uint32_t>(current_node());
+    return tls_homeNode_;
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline std::uint32_t bcpp::implementation::numa_work_contract_group<T>::node_count
+(
+) const
+{
+    return partitions_.size();
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline auto bcpp::implementation::numa_work_contract_group<T>::get_partition
+(
+    numa_node numaNode
+) -> work_contract_group_type &
+{
+    return *partitions_[static_cast<std::uint32_t>(numaNode) % partitions_.size()];
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+
+
+namespace bcpp
+{
+
+    // contracts within a work_contract_group are partitioned into priority bands.
+    // band zero is the highest priority.  use priority_band{n} for lower bands.
+    enum class priority_band : std::uint64_t 
+    {
+        highest = 0
+    };
+
+} // namespace bcpp
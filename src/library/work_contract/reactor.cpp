@@ -0,0 +1,444 @@
+#include "./reactor.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+
+
+namespace
+{
+
+    // user_data of io_uring poll remove requests (registrations are never at this address)
+    static auto constexpr poll_remove_tag = 1ull;
+
+    static auto constexpr io_uring_entries = 1024u;
+
+} // namespace
+
+
+//=============================================================================
+// a minimal io_uring (the submission and completion rings mapped from the kernel).
+// submissions are made under the reactor's mutex.  completions are consumed only
+// by the reactor thread.
+struct bcpp::implementation::reactor::io_uring_ring
+{
+    ~io_uring_ring()
+    {
+        if (sqes_ != nullptr)
+            ::munmap(sqes_, sqesSize_);
+        if ((cqRing_ != nullptr) && (cqRing_ != sqRing_))
+            ::munmap(cqRing_, cqRingSize_);
+        if (sqRing_ != nullptr)
+            ::munmap(sqRing_, sqRingSize_);
+        if (fd_ >= 0)
+            ::close(fd_);
+    }
+
+    bool setup
+    (
+        unsigned entries
+    )
+    {
+        io_uring_params params{};
+        if ((fd_ = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params))) < 0)
+            return false;
+        // multishot polls (IORING_POLL_ADD_MULTI) arrived in linux 5.13, as did IORING_FEAT_RSRC_TAGS
+        if ((params.features & IORING_FEAT_RSRC_TAGS) == 0)
+            return false;
+        sqRingSize_ = (params.sq_off.array + (params.sq_entries * sizeof(unsigned)));
+        cqRingSize_ = (params.cq_off.cqes + (params.cq_entries * sizeof(io_uring_cqe)));
+        if (params.features & IORING_FEAT_SINGLE_MMAP)
+            sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+        if ((sqRing_ = map(sqRingSize_, IORING_OFF_SQ_RING)) == nullptr)
+            return false;
+        cqRing_ = (params.features & IORING_FEAT_SINGLE_MMAP) ? sqRing_ : map(cqRingSize_, IORING_OFF_CQ_RING);
+        if (cqRing_ == nullptr)
+            return false;
+        sqesSize_ = (params.sq_entries * sizeof(io_uring_sqe));
+        if ((sqes_ = reinterpret_cast<io_uring_sqe *>(map(sqesSize_, IORING_OFF_SQES))) == nullptr)
+            return false;
+
+        auto sq = reinterpret_cast<char *>(sqRing_);
+        sqHead_ = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+        sqTail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+        sqMask_ = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+        sqArray_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+        sqEntries_ = params.sq_entries;
+        auto cq = reinterpret_cast<char *>(cqRing_);
+        cqHead_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+        cqTail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+        cqMask_ = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+        return true;
+    }
+
+    void * map
+    (
+        std::size_t size,
+        off_t offset
+    )
+    {
+        auto address = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, offset);
+        return (address == MAP_FAILED) ? nullptr : address;
+    }
+
+    // queue a submission (the caller holds the reactor's mutex).  submissions
+    // are handed to the kernel by the next enter().
+    bool push
+    (
+        io_uring_sqe const & sqe
+    )
+    {
+        auto tail = *sqTail_;
+        if ((tail - std::atomic_ref(*sqHead_).load(std::memory_order_acquire)) >= sqEntries_)
+        {
+            // full. submit what is queued to make room.
+            enter(0, 0);
+            if ((tail - std::atomic_ref(*sqHead_).load(std::memory_order_acquire)) >= sqEntries_)
+                return false;
+        }
+        auto index = (tail & sqMask_);
+        sqes_[index] = sqe;
+        sqArray_[index] = index;
+        std::atomic_ref(*sqTail_).store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // submit everything queued (the kernel submits at most what is queued) and 
+    // optionally wait for completions
+    int enter
+    (
+        unsigned minComplete,
+        unsigned flags
+    )
+    {
+        return static_cast<int>(::syscall(__NR_io_uring_enter, fd_, sqEntries_, minComplete, flags, nullptr, 0));
+    }
+
+    int             fd_{-1};
+    void *          sqRing_{nullptr};
+    std::size_t     sqRingSize_{0};
+    void *          cqRing_{nullptr};
+    std::size_t     cqRingSize_{0};
+    io_uring_sqe *  sqes_{nullptr};
+    std::size_t     sqesSize_{0};
+    unsigned *      sqHead_{nullptr};
+    unsigned *      sqTail_{nullptr};
+    unsigned        sqMask_{0};
+    unsigned *      sqArray_{nullptr};
+    unsigned        sqEntries_{0};
+    unsigned *      cqHead_{nullptr};
+    unsigned *      cqTail_{nullptr};
+    unsigned        cqMask_{0};
+    io_uring_cqe *  cqes_{nullptr};
+};
+
+
+//=============================================================================
+bcpp::implementation::reactor::reactor
+(
+    backend requestedBackend
+)
+{
+    wakeFd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    wakeRegistration_.fd_ = wakeFd_;
+    wakeRegistration_.events_ = static_cast<std::uint32_t>(interest::readable);
+
+    if (requestedBackend == backend::io_uring)
+    {
+        ring_ = std::make_unique<io_uring_ring>();
+        if ((ring_->setup(io_uring_entries)) && (submit_poll(&wakeRegistration_)))
+            backend_ = backend::io_uring;
+        else
+            ring_.reset();
+    }
+    if (backend_ == backend::epoll)
+    {
+        epollFd_ = ::epoll_create1(EPOLL_CLOEXEC);
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.ptr = &wakeRegistration_;
+        ::epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeFd_, &event);
+    }
+    thread_ = std::jthread([this](){run();});
+}
+
+
+//=============================================================================
+bcpp::implementation::reactor::~reactor
+(
+)
+{
+    stop();
+    free_retired();
+    for (auto [fd, registration] : registrations_)
+        delete registration;
+    for (auto registration : removing_)
+        delete registration;
+    ring_.reset();
+    if (epollFd_ >= 0)
+        ::close(epollFd_);
+    if (wakeFd_ >= 0)
+        ::close(wakeFd_);
+}
+
+
+//=============================================================================
+void bcpp::implementation::reactor::stop
+(
+)
+{
+    if (bool wasRunning = !stopped_.exchange(true); wasRunning)
+    {
+        std::uint64_t value = 1;
+        [[maybe_unused]] auto _ = ::write(wakeFd_, &value, sizeof(value));
+        if ((thread_.joinable()) && (thread_.get_id() != std::this_thread::get_id()))
+            thread_.join();
+    }
+}
+
+
+//=============================================================================
+auto bcpp::implementation::reactor::get_backend
+(
+) const noexcept -> backend
+{
+    return backend_;
+}
+
+
+//=============================================================================
+bool bcpp::implementation::reactor::add
+(
+    // takes ownership of the registration
+    registration * newRegistration
+)
+{
+    std::lock_guard lockGuard(mutex_);
+    if (registrations_.contains(newRegistration->fd_))
+    {
+        delete newRegistration;
+        return false;
+    }
+    if (backend_ == backend::epoll)
+    {
+        epoll_event event{};
+        event.events = (newRegistration->events_ | EPOLLET);
+        event.data.ptr = newRegistration;
+        if (::epoll_ctl(epollFd_, EPOLL_CTL_ADD, newRegistration->fd_, &event) != 0)
+        {
+            delete newRegistration;
+            return false;
+        }
+    }
+    else
+    {
+        if (!submit_poll(newRegistration))
+        {
+            delete newRegistration;
+            return false;
+        }
+        ring_->enter(0, 0);
+    }
+    registrations_[newRegistration->fd_] = newRegistration;
+    return true;
+}
+
+
+//=============================================================================
+bool bcpp::implementation::reactor::remove
+(
+    int fd
+)
+{
+    std::lock_guard lockGuard(mutex_);
+    auto iter = registrations_.find(fd);
+    if (iter == registrations_.end())
+        return false;
+    auto registration = iter->second;
+    registrations_.erase(iter);
+    if (backend_ == backend::epoll)
+    {
+        ::epoll_ctl(epollFd_, EPOLL_CTL_DEL, fd, nullptr);
+        // the reactor thread may be dispatching an event for this registration.
+        // it is freed by the reactor thread once the current batch is complete.
+        auto head = retired_.load(std::memory_order_relaxed);
+        do
+        {
+            registration->next_ = head;
+        } while (!retired_.compare_exchange_weak(head, registration, std::memory_order_release, std::memory_order_relaxed));
+    }
+    else
+    {
+        // the registration is freed when the reactor thread sees the final completion of its poll
+        registration->removed_ = true;
+        if (!registration->armed_)
+        {
+            delete registration;
+            return true;
+        }
+        removing_.insert(registration);
+        submit_poll_remove(registration);
+        ring_->enter(0, 0);
+    }
+    return true;
+}
+
+
+//=============================================================================
+bool bcpp::implementation::reactor::submit_poll
+(
+    // (the caller holds mutex_ or is the constructor)
+    registration * target
+)
+{
+    io_uring_sqe sqe{};
+    sqe.opcode = IORING_OP_POLL_ADD;
+    sqe.fd = target->fd_;
+    sqe.poll32_events = target->events_;
+    // multishot: the poll stays armed and completes once per readiness notification
+    // (edge triggered, as with EPOLLET) rather than completing at once if the
+    // descriptor is still ready as a re-armed one shot poll would
+    sqe.len = IORING_POLL_ADD_MULTI;
+    sqe.user_data = reinterpret_cast<std::uint64_t>(target);
+    return ring_->push(sqe);
+}
+
+
+//=============================================================================
+bool bcpp::implementation::reactor::submit_poll_remove
+(
+    // (the caller holds mutex_)
+    registration * target
+)
+{
+    io_uring_sqe sqe{};
+    sqe.opcode = IORING_OP_POLL_REMOVE;
+    sqe.fd = -1;
+    sqe.addr = reinterpret_cast<std::uint64_t>(target);
+    sqe.user_data = poll_remove_tag;
+    return ring_->push(sqe);
+}
+
+
+//=============================================================================
+void bcpp::implementation::reactor::run
+(
+)
+{
+    pthread_setname_np(pthread_self(), "wc_reactor");
+    if (backend_ == backend::epoll)
+        run_epoll();
+    else
+        run_io_uring();
+}
+
+
+//=============================================================================
+void bcpp::implementation::reactor::run_epoll
+(
+)
+{
+    std::array<epoll_event, max_events_per_wait> events;
+    while (!stopped_.load(std::memory_order_relaxed))
+    {
+        auto count = ::epoll_wait(epollFd_, events.data(), events.size(), -1);
+        for (auto i = 0; i < count; ++i)
+        {
+            if (auto registration = reinterpret_cast<struct registration *>(events[i].data.ptr); registration != &wakeRegistration_)
+                registration->schedule_(registration->contractId_, registration->group_);
+            else
+                drain_wake_fd();
+        }
+        free_retired();
+    }
+}
+
+
+//=============================================================================
+void bcpp::implementation::reactor::run_io_uring
+(
+    // polls are multishot and remain armed until their final completion (one without
+    // IORING_CQE_F_MORE).  a poll which ended without failing (the kernel can end a 
+    // multishot poll at any time) is re-armed with the wait for the next batch.
+    // a registration is freed, rather than re-armed, once removed.
+)
+{
+    // (registration, whether its poll failed or was cancelled)
+    std::vector<std::pair<registration *, bool>> ended;
+    ended.reserve(io_uring_entries * 2);
+    while (!stopped_.load(std::memory_order_relaxed))
+    {
+        if (!ended.empty())
+        {
+            std::lock_guard lockGuard(mutex_);
+            for (auto [registration, failed] : ended)
+            {
+                if (registration->removed_)
+                {
+                    removing_.erase(registration);
+                    delete registration;
+                }
+                else if ((failed) || (!submit_poll(registration)))
+                {
+                    registration->armed_ = false;
+                }
+            }
+        }
+        ended.clear();
+        if (auto result = ring_->enter(1, IORING_ENTER_GETEVENTS); (result < 0) && (errno != EINTR) && (errno != EBUSY))
+            break;
+
+        auto head = *ring_->cqHead_;
+        auto tail = std::atomic_ref(*ring_->cqTail_).load(std::memory_order_acquire);
+        // a registration reaches this thread through the kernel (its poll was pushed
+        // by add() on another thread).  a completion means that the kernel has consumed
+        // the poll so this acquire pairs with the release of the push that queued it.
+        std::atomic_ref(*ring_->sqTail_).load(std::memory_order_acquire);
+        for (; head != tail; ++head)
+        {
+            auto const & cqe = ring_->cqes_[head & ring_->cqMask_];
+            if (cqe.user_data == poll_remove_tag)
+                continue;
+            auto registration = reinterpret_cast<struct registration *>(cqe.user_data);
+            if (registration == &wakeRegistration_)
+                drain_wake_fd();
+            else if (cqe.res > 0)
+                registration->schedule_(registration->contractId_, registration->group_);
+            // a cancelled or failed poll is not re-armed
+            if ((cqe.flags & IORING_CQE_F_MORE) == 0)
+                ended.emplace_back(registration, cqe.res < 0);
+        }
+        std::atomic_ref(*ring_->cqHead_).store(head, std::memory_order_release);
+    }
+}
+
+
+//=============================================================================
+void bcpp::implementation::reactor::drain_wake_fd
+(
+) noexcept
+{
+    std::uint64_t value;
+    [[maybe_unused]] auto _ = ::read(wakeFd_, &value, sizeof(value));
+}
+
+
+//=============================================================================
+void bcpp::implementation::reactor::free_retired
+(
+) noexcept
+{
+    for (auto registration = retired_.exchange(nullptr, std::memory_order_acquire); registration != nullptr; )
+        delete std::exchange(registration, registration->next_);
+}
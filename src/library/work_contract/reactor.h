@@ -0,0 +1,197 @@
+#pragma once
+
+#include "./work_contract.h"
+#include "./work_contract_id.h"
+
+#include <include/synchronization_mode.h>
+#include <include/non_copyable.h>
+#include <include/non_movable.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+
+namespace bcpp::implementation
+{
+
+    //=========================================================================
+    // schedules work contracts when file descriptors become ready.  a single
+    // reactor thread waits on either epoll or io_uring (multishot polls, linux 5.13
+    // or later) and calls schedule() for each ready descriptor directly from its
+    // completion loop.  with either backend readiness is edge triggered:
+    // a contract is scheduled when new data arrives, so it should consume until the
+    // descriptor would block (or reschedule itself).  readiness which arrives while
+    // the contract is already scheduled coalesces into the one execution.
+    // events which are being dispatched when remove() is called may still schedule
+    // the contract after remove() returns.  scheduling a released contract is a no-op.
+    class reactor :
+        non_copyable,
+        non_movable
+    {
+    public:
+
+        enum class backend
+        {
+            epoll,
+            io_uring
+        };
+
+        // values are those of EPOLLIN/POLLIN and EPOLLOUT/POLLOUT
+        enum class interest : std::uint32_t
+        {
+            readable = 0x001,
+            writable = 0x004,
+            read_write = (readable | writable)
+        };
+
+        // if io_uring is requested but is not available then epoll is used
+        explicit reactor
+        (
+            backend = backend::epoll
+        );
+
+        ~reactor();
+
+        template <synchronization_mode T>
+        bool add
+        (
+            int,
+            work_contract<T> const &,
+            interest = interest::readable
+        );
+
+        bool remove
+        (
+            int
+        );
+
+        void stop();
+
+        backend get_backend() const noexcept;
+
+    private:
+
+        using schedule_function = bool(*)(work_contract_id, void *);
+
+        // published to the reactor thread by the system call which registers it
+        // (epoll_ctl or io_uring_enter) and read only by that thread thereafter
+        struct registration
+        {
+            schedule_function   schedule_;
+            void *              group_;
+            work_contract_id    contractId_;
+            int                 fd_;
+            std::uint32_t       events_;
+            registration *      next_{nullptr};
+            // io_uring only (guarded by mutex_)
+            bool                removed_{false};
+            bool                armed_{true};
+        };
+
+        struct io_uring_ring;
+
+        static auto constexpr max_events_per_wait = 256;
+
+        template <synchronization_mode T>
+        static bool schedule
+        (
+            work_contract_id,
+            void *
+        );
+
+        bool add
+        (
+            registration *
+        );
+
+        void run();
+
+        void run_epoll();
+
+        void run_io_uring();
+
+        bool submit_poll
+        (
+            registration *
+        );
+
+        bool submit_poll_remove
+        (
+            registration *
+        );
+
+        void drain_wake_fd() noexcept;
+
+        void free_retired() noexcept;
+
+        backend                                         backend_{backend::epoll};
+
+        int                                             epollFd_{-1};
+
+        int                                             wakeFd_{-1};
+
+        std::unique_ptr<io_uring_ring>                  ring_;
+
+        registration                                    wakeRegistration_{};
+
+        std::atomic<bool>                               stopped_{false};
+
+        std::mutex mutable                              mutex_;
+
+        std::unordered_map<int, registration *>         registrations_;
+
+        // io_uring: removed registrations awaiting their final completion
+        std::unordered_set<registration *>              removing_;
+
+        // epoll: removed registrations, freed by the reactor thread between waits
+        std::atomic<registration *>                     retired_{nullptr};
+
+        std::jthread                                    thread_;
+
+    }; // class reactor
+
+} // namespace bcpp::implementation
+
+
+namespace bcpp
+{
+
+    using reactor = implementation::reactor;
+
+} // namespace bcpp
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline bool bcpp::implementation::reactor::add
+(
+    // schedule the contract whenever the descriptor becomes ready for the specified
+    // interest.  returns false if the descriptor is already registered (or can not be).
+    int fd,
+    work_contract<T> const & contract,
+    interest events
+)
+{
+    auto group = contract.owner_.load(std::memory_order_relaxed);
+    if (group == nullptr)
+        return false;
+    return add(new registration{&schedule<T>, group, contract.get_id(), fd, static_cast<std::uint32_t>(events)});
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline bool bcpp::implementation::reactor::schedule
+(
+    work_contract_id contractId,
+    void * group
+)
+{
+    return reinterpret_cast<work_contract_group<T> *>(group)->schedule(contractId);
+}
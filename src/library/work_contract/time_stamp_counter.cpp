@@ -0,0 +1,28 @@
+#include "./time_stamp_counter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+
+//=============================================================================
+double bcpp::implementation::tsc_ticks_per_nanosecond
+(
+    // calibrated against steady_clock over a short interval the first time it is called
+)
+{
+    static double const ticksPerNanosecond = []()
+            {
+                #if defined(__x86_64__) || defined(__i386__)
+                    auto startTime = std::chrono::steady_clock::now();
+                    auto startTicks = read_tsc();
+                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                    auto ticks = (read_tsc() - startTicks);
+                    auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count();
+                    return (static_cast<double>(ticks) / std::max<std::int64_t>(nanoseconds, 1));
+                #else
+                    return 1.0;
+                #endif
+            }();
+    return ticksPerNanosecond;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+
+#if !defined(__x86_64__) && !defined(__i386__)
+    #include <ctime>
+#endif
+
+
+namespace bcpp::implementation
+{
+
+    //=========================================================================
+    // the time stamp counter (or, where there is none, nanoseconds)
+    inline std::uint64_t read_tsc
+    (
+    ) noexcept
+    {
+        #if defined(__x86_64__) || defined(__i386__)
+            return __builtin_ia32_rdtsc();
+        #else
+            timespec now;
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            return ((now.tv_sec * 1'000'000'000ull) + now.tv_nsec);
+        #endif
+    }
+
+
+    // time stamp counter ticks per nanosecond (measured once, on first use)
+    double tsc_ticks_per_nanosecond();
+
+} // namespace bcpp::implementation
@@ -0,0 +1,255 @@
+#include "./timer_service.h"
+
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+#include <pthread.h>
+
+
+//=============================================================================
+bcpp::implementation::timer_service::timer_service
+(
+    // scheduleFunction(contractId, group) schedules the contract, returning false
+    // if the contract is no longer valid
+    schedule_function scheduleFunction,
+    void * group
+):
+    schedule_(scheduleFunction),
+    group_(group),
+    origin_(clock_type::now())
+{
+    thread_ = std::jthread([this](){run();});
+}
+
+
+//=============================================================================
+bcpp::implementation::timer_service::~timer_service
+(
+)
+{
+    stop();
+    auto deleteAll = [](timer * t){while (t) delete std::exchange(t, t->next_);};
+    deleteAll(incoming_.exchange(nullptr));
+    deleteAll(overflow_);
+    for (auto & level : slots_)
+        for (auto t : level)
+            deleteAll(t);
+}
+
+
+//=============================================================================
+void bcpp::implementation::timer_service::stop
+(
+)
+{
+    if (bool wasRunning = !stopped_.exchange(true); wasRunning)
+    {
+        waitableState_.notify_all();
+        if ((thread_.joinable()) && (thread_.get_id() != std::this_thread::get_id()))
+            thread_.join();
+    }
+}
+
+
+//=============================================================================
+void bcpp::implementation::timer_service::schedule_at
+(
+    work_contract_id contractId,
+    time_point when
+)
+{
+    push(new timer{nullptr, contractId, std::chrono::nanoseconds(when - origin_).count(), 0});
+}
+
+
+//=============================================================================
+void bcpp::implementation::timer_service::schedule_every
+(
+    // schedule at first and then at every period thereafter
+    work_contract_id contractId,
+    time_point first,
+    std::chrono::nanoseconds period
+)
+{
+    push(new timer{nullptr, contractId, std::chrono::nanoseconds(first - origin_).count(), std::max<std::int64_t>(1, period.count())});
+}
+
+
+//=============================================================================
+void bcpp::implementation::timer_service::push
+(
+    // hand a timer to the tick thread.  only the push which finds the stack empty
+    // needs to wake the tick thread.
+    timer * newTimer
+)
+{
+    auto head = incoming_.load(std::memory_order_relaxed);
+    do
+    {
+        newTimer->next_ = head;
+    } while (!incoming_.compare_exchange_weak(head, newTimer, std::memory_order_release, std::memory_order_relaxed));
+    if (head == nullptr)
+        waitableState_.notify_one();
+}
+
+
+//=============================================================================
+void bcpp::implementation::timer_service::run
+(
+)
+{
+    pthread_setname_np(pthread_self(), "wc_timer");
+    auto ready = [this](){return ((incoming_.load(std::memory_order_relaxed) != nullptr) || (stopped_));};
+    while (!stopped_)
+    {
+        for (auto t = incoming_.exchange(nullptr, std::memory_order_acquire); t != nullptr; )
+            insert(std::exchange(t, t->next_));
+        advance(elapsed_ticks());
+        if (auto nextTick = next_tick(); nextTick == no_tick)
+        {
+            waitableState_.wait(ready);
+        }
+        else
+        {
+            auto wakeTime = (origin_ + std::chrono::nanoseconds(nextTick * resolution_ns));
+            if (auto timeout = (wakeTime - clock_type::now()); timeout > std::chrono::nanoseconds(0))
+                waitableState_.wait_for(ready, timeout);
+        }
+    }
+}
+
+
+//=============================================================================
+void bcpp::implementation::timer_service::insert
+(
+    // a timer is placed in the lowest level for which its tick and the current tick
+    // share the same block of the level above.  its slot at that level is therefore
+    // always ahead of the current tick's slot and it is cascaded (moved down a level)
+    // when the current tick enters its block.
+    timer * t
+)
+{
+    auto tick = ((t->deadline_ <= 0) ? 0ull : static_cast<std::uint64_t>((t->deadline_ + resolution_ns - 1) / resolution_ns));
+    if (tick <= currentTick_)
+    {
+        expire(t);
+        return;
+    }
+    for (auto level = 0ull; level < level_count; ++level)
+    {
+        auto shift = (slot_bits * (level + 1));
+        if ((tick >> shift) == (currentTick_ >> shift))
+        {
+            auto slot = ((tick >> (slot_bits * level)) & slot_mask);
+            t->next_ = std::exchange(slots_[level][slot], t);
+            occupied_[level] |= (1ull << slot);
+            return;
+        }
+    }
+    t->next_ = std::exchange(overflow_, t);
+}
+
+
+//=============================================================================
+void bcpp::implementation::timer_service::expire
+(
+    timer * t
+)
+{
+    if ((!schedule_(t->contractId_, group_)) || (t->period_ == 0))
+    {
+        delete t;
+        return;
+    }
+    // re-arm from the previous deadline.  if the tick thread has fallen behind
+    // by more than a period then the missed firings are skipped (keeping the phase).
+    t->deadline_ += t->period_;
+    if (auto now = static_cast<std::int64_t>(currentTick_ * resolution_ns); t->deadline_ <= now)
+        t->deadline_ += (((now - t->deadline_) / t->period_) + 1) * t->period_;
+    insert(t);
+}
+
+
+//=============================================================================
+void bcpp::implementation::timer_service::advance
+(
+    std::uint64_t targetTick
+)
+{
+    while (currentTick_ < targetTick)
+    {
+        // ticks at which there is nothing to expire or cascade are skipped
+        if (auto nextTick = next_tick(); nextTick > targetTick)
+        {
+            currentTick_ = targetTick;
+            return;
+        }
+        else
+        {
+            currentTick_ = nextTick;
+        }
+        // entering a new block at one or more levels.  cascade from the highest
+        // such level down so that timers cascaded into a lower level's current
+        // slot are cascaded again.
+        auto level = 0ull;
+        while ((level < level_count) && ((currentTick_ & ((1ull << (slot_bits * (level + 1))) - 1)) == 0))
+            ++level;
+        if (level == level_count)
+        {
+            for (auto t = std::exchange(overflow_, nullptr); t != nullptr; )
+                insert(std::exchange(t, t->next_));
+            --level;
+        }
+        for (; level > 0; --level)
+            cascade(level, (currentTick_ >> (slot_bits * level)) & slot_mask);
+        cascade(0, currentTick_ & slot_mask);
+    }
+}
+
+
+//=============================================================================
+void bcpp::implementation::timer_service::cascade
+(
+    // reinsert (or, at level zero, expire) every timer in the specified slot
+    std::uint64_t level,
+    std::uint64_t slot
+)
+{
+    if ((occupied_[level] & (1ull << slot)) == 0)
+        return;
+    occupied_[level] &= ~(1ull << slot);
+    for (auto t = std::exchange(slots_[level][slot], nullptr); t != nullptr; )
+        insert(std::exchange(t, t->next_));
+}
+
+
+//=============================================================================
+std::uint64_t bcpp::implementation::timer_service::next_tick
+(
+    // the next tick at which a timer might expire.  the first occupied slot, after
+    // the current one, of the lowest level which has one gives either the tick (level 
+    // zero) or the start of the block to cascade (higher levels).  otherwise the 
+    // start of the next top level block if there are overflowed timers.
+) const noexcept
+{
+    for (auto level = 0ull; level < level_count; ++level)
+    {
+        auto shift = (slot_bits * level);
+        auto nextSlot = (((currentTick_ >> shift) & slot_mask) + 1);
+        if (auto later = (nextSlot < slot_count) ? (occupied_[level] >> nextSlot) : 0ull; later != 0)
+            return (((currentTick_ >> shift) + 1 + std::countr_zero(later)) << shift);
+    }
+    if (overflow_ != nullptr)
+        return (((currentTick_ >> (slot_bits * level_count)) + 1) << (slot_bits * level_count));
+    return no_tick;
+}
+
+
+//=============================================================================
+std::uint64_t bcpp::implementation::timer_service::elapsed_ticks
+(
+) const noexcept
+{
+    return (std::chrono::nanoseconds(clock_type::now() - origin_).count() / resolution_ns);
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "./work_contract_id.h"
+#include "./waitable_state.h"
+
+#include <include/non_copyable.h>
+#include <include/non_movable.h>
+
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <array>
+#include <thread>
+
+
+namespace bcpp::implementation
+{
+
+    //=========================================================================
+    // schedules contracts at (or after) a point in time.  timers are held in a
+    // hierarchical timing wheel (four levels of 64 slots, with a tick of resolution)
+    // which is owned by a single tick thread so the wheel itself needs no locks.
+    // other threads hand timers to the tick thread via a lock free stack.  the tick
+    // thread sleeps until the next occupied slot (or indefinitely when there are no
+    // timers).  deadlines beyond the range of the wheel (about 28 minutes) wait in
+    // an overflow list.  periodic timers are re-armed from their previous deadline
+    // rather than from the time at which they fired, so they do not drift, and reuse
+    // their node.  a timer whose contract is no longer valid (schedule fails) is
+    // discarded, which also ends a periodic schedule.
+    class timer_service :
+        non_copyable,
+        non_movable
+    {
+    public:
+
+        using clock_type = std::chrono::steady_clock;
+        using time_point = clock_type::time_point;
+        using schedule_function = bool(*)(work_contract_id, void *);
+
+        static auto constexpr resolution = std::chrono::microseconds(100);
+
+        timer_service
+        (
+            schedule_function,
+            void *
+        );
+
+        ~timer_service();
+
+        void schedule_at
+        (
+            work_contract_id,
+            time_point
+        );
+
+        void schedule_every
+        (
+            work_contract_id,
+            time_point,
+            std::chrono::nanoseconds
+        );
+
+        void stop();
+
+    private:
+
+        struct timer
+        {
+            timer *             next_;
+            work_contract_id    contractId_;
+            std::int64_t        deadline_;  // nanoseconds since origin_
+            std::int64_t        period_;    // zero for one shot timers
+        };
+
+        static auto constexpr level_count = 4;
+        static auto constexpr slot_bits = 6;
+        static auto constexpr slot_count = (1ull << slot_bits);
+        static auto constexpr slot_mask = (slot_count - 1);
+        static auto constexpr resolution_ns = std::chrono::nanoseconds(resolution).count();
+        static auto constexpr no_tick = ~0ull;
+
+        void push(timer *);
+
+        void run();
+
+        void insert(timer *);
+
+        void expire(timer *);
+
+        void advance(std::uint64_t);
+
+        void cascade
+        (
+            std::uint64_t,
+            std::uint64_t
+        );
+
+        std::uint64_t next_tick() const noexcept;
+
+        std::uint64_t elapsed_ticks() const noexcept;
+
+        schedule_function                                               schedule_;
+
+        void *                                                          group_;
+
+        time_point const                                                origin_;
+
+        std::atomic<timer *>                                            incoming_{nullptr};
+
+        std::atomic<bool>                                               stopped_{false};
+
+        waitable_state                                                  waitableState_;
+
+        // owned by the tick thread
+        std::uint64_t                                                   currentTick_{0};
+
+        std::array<std::array<timer *, slot_count>, level_count>        slots_{};
+
+        std::array<std::uint64_t, level_count>                          occupied_{};
+
+        timer *                                                         overflow_{nullptr};
+
+        std::jthread                                                    thread_;
+
+    }; // class timer_service
+
+} // namespace bcpp::implementation
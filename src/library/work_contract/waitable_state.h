@@ -0,0 +1,304 @@
+#pragma once
+
+#include <include/non_copyable.h>
+#include <include/non_movable.h>
+
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <algorithm>
+
+#if defined(__linux__)
+    #include <linux/futex.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+    #include <ctime>
+#else
+    #include <thread>
+#endif
+
+
+namespace bcpp::implementation
+{
+
+    //=========================================================================
+    inline void cpu_pause
+    (
+    ) noexcept
+    {
+        #if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+        #elif defined(__aarch64__)
+            asm volatile("yield");
+        #endif
+    }
+
+
+    //=========================================================================
+    // parks the worker threads of a blocking work_contract_group while there is
+    // no work.  workers register in parkedCount_ before re-checking for work and
+    // then sleep on the futex word epoch_.  notifiers only advance epoch_ (and make
+    // the wake syscall) when parkedCount_ is non zero, so when no worker is parked
+    // the cost to the scheduling thread is a single load.
+    // optionally, waiting workers first spin for up to spinWindow_ before parking
+    // (spin then park).  with adaptive spinning each thread halves its own spin limit
+    // each time spinning fails to find work and doubles it (up to spinWindow_) each
+    // time it succeeds.
+    // a notifier wakes a single worker.  a woken worker does not pass the wake on
+    // itself.  the owner wakes another worker once work has been claimed and some
+    // remains (see work_contract_group::subtree_remains_filled).
+    class alignas(64) waitable_state final :
+        non_copyable,
+        non_movable
+    {
+    public:
+
+        waitable_state() = default;
+
+        // wake one parked worker (if any)
+        void notify_one() noexcept;
+
+        // wake every parked worker (if any)
+        void notify_all() noexcept;
+
+        void set_spin_window
+        (
+            std::chrono::nanoseconds,
+            bool
+        ) noexcept;
+
+        std::chrono::nanoseconds get_spin_window() const noexcept;
+
+        // park until ready() returns true
+        template <typename P>
+        void wait
+        (
+            P ready
+        ) noexcept;
+
+        // park until ready() returns true or the duration has elapsed.
+        // returns the final result of ready().
+        template <typename P>
+        bool wait_for
+        (
+            P ready,
+            std::chrono::nanoseconds
+        ) noexcept;
+
+    private:
+
+        void notify
+        (
+            int
+        ) noexcept;
+
+        template <typename P>
+        bool spin
+        (
+            P,
+            std::int64_t
+        ) const noexcept;
+
+        void park
+        (
+            std::uint32_t,
+            std::chrono::nanoseconds const *
+        ) const noexcept;
+
+        std::atomic<std::uint32_t> mutable  epoch_{0};
+        std::atomic<std::uint32_t>          parkedCount_{0};
+
+        std::atomic<std::int64_t>           spinWindow_{0};
+        std::atomic<bool>                   adaptiveSpin_{false};
+
+        // the smallest adaptive spin limit as a fraction of the spin window
+        static auto constexpr min_adaptive_spin_shift = 6;
+
+        static std::int64_t thread_local    tls_spinLimit_;
+
+        static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t));
+        static_assert(std::atomic<std::uint32_t>::is_always_lock_free);
+
+    }; // class waitable_state
+
+    inline std::int64_t thread_local waitable_state::tls_spinLimit_ = INT64_MAX;
+
+} // namespace bcpp::implementation
+
+
+//=============================================================================
+inline void bcpp::implementation::waitable_state::notify_one
+(
+) noexcept
+{
+    notify(1);
+}
+
+
+//=============================================================================
+inline void bcpp::implementation::waitable_state::notify_all
+(
+) noexcept
+{
+    notify(INT_MAX);
+}
+
+
+//=============================================================================
+inline void bcpp::implementation::waitable_state::set_spin_window
+(
+    // a zero spin window parks immediately
+    std::chrono::nanoseconds spinWindow,
+    bool adaptive
+) noexcept
+{
+    spinWindow_.store(std::max<std::int64_t>(0, spinWindow.count()), std::memory_order_relaxed);
+    adaptiveSpin_.store(adaptive, std::memory_order_relaxed);
+}
+
+
+//=============================================================================
+inline std::chrono::nanoseconds bcpp::implementation::waitable_state::get_spin_window
+(
+) const noexcept
+{
+    return std::chrono::nanoseconds(spinWindow_.load(std::memory_order_relaxed));
+}
+
+
+//=============================================================================
+template <typename P>
+inline bool bcpp::implementation::waitable_state::spin
+(
+    // spin (with a cpu pause) until ready() returns true or the spin limit (or the 
+    // specified maximum duration) has elapsed.  the clock is checked once per 64 spins.
+    P ready,
+    std::int64_t maxDuration
+) const noexcept
+{
+    auto spinWindow = spinWindow_.load(std::memory_order_relaxed);
+    if (spinWindow == 0)
+        return false;
+    auto adaptive = adaptiveSpin_.load(std::memory_order_relaxed);
+    auto & spinLimit = tls_spinLimit_;
+    spinLimit = adaptive ? std::clamp(spinLimit, std::max<std::int64_t>(1, spinWindow >> min_adaptive_spin_shift), spinWindow) : spinWindow;
+
+    auto limit = std::min(spinLimit, maxDuration);
+    auto start = std::chrono::steady_clock::now();
+    while (true)
+    {
+        for (auto i = 0; i < 64; ++i)
+        {
+            if (ready())
+            {
+                if (adaptive)
+                    spinLimit = std::min(spinLimit * 2, spinWindow);
+                return true;
+            }
+            cpu_pause();
+        }
+        if (std::chrono::nanoseconds(std::chrono::steady_clock::now() - start).count() >= limit)
+            break;
+    }
+    if (adaptive)
+        spinLimit /= 2;
+    return false;
+}
+
+
+//=============================================================================
+inline void bcpp::implementation::waitable_state::notify
+(
+    // the load of parkedCount_ must be sequentially consistent with respect to the
+    // notifier's prior update of the state which ready() observes.  paired with
+    // the increment of parkedCount_ in wait() this ensures that either the notifier
+    // sees the parked worker or the worker sees the update.
+    int count
+) noexcept
+{
+    if (parkedCount_.load() == 0)
+        return;
+    epoch_.fetch_add(1);
+    #if defined(__linux__)
+        ::syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&epoch_), FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+    #else
+        if (count == 1)
+            epoch_.notify_one();
+        else
+            epoch_.notify_all();
+    #endif
+}
+
+
+//=============================================================================
+inline void bcpp::implementation::waitable_state::park
+(
+    // sleep while epoch_ == epoch (or until the timeout, if any, has elapsed).
+    // may return spuriously.
+    std::uint32_t epoch,
+    std::chrono::nanoseconds const * timeout
+) const noexcept
+{
+    #if defined(__linux__)
+        if (timeout)
+        {
+            auto seconds = std::chrono::duration_cast<std::chrono::seconds>(*timeout);
+            timespec timeSpec{static_cast<time_t>(seconds.count()), static_cast<long>((*timeout - seconds).count())};
+            ::syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&epoch_), FUTEX_WAIT_PRIVATE, epoch, &timeSpec, nullptr, 0);
+        }
+        else
+        {
+            ::syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&epoch_), FUTEX_WAIT_PRIVATE, epoch, nullptr, nullptr, 0);
+        }
+    #else
+        // std::atomic::wait has no timed variant.  timed waits poll instead.
+        if (timeout)
+            std::this_thread::sleep_for(std::min<std::chrono::nanoseconds>(*timeout, std::chrono::microseconds(50)));
+        else
+            epoch_.wait(epoch);
+    #endif
+}
+
+
+//=============================================================================
+template <typename P>
+inline void bcpp::implementation::waitable_state::wait
+(
+    P ready
+) noexcept
+{
+    if ((ready()) || (spin(ready, INT64_MAX)))
+        return;
+    parkedCount_.fetch_add(1);
+    for (auto epoch = epoch_.load(); !ready(); epoch = epoch_.load())
+        park(epoch, nullptr);
+    parkedCount_.fetch_sub(1);
+}
+
+
+//=============================================================================
+template <typename P>
+inline bool bcpp::implementation::waitable_state::wait_for
+(
+    P ready,
+    std::chrono::nanoseconds duration
+) noexcept
+{
+    if (ready())
+        return true;
+    auto deadline = std::chrono::steady_clock::now() + duration;
+    if (spin(ready, duration.count()))
+        return true;
+    parkedCount_.fetch_add(1);
+    auto isReady = false;
+    for (auto epoch = epoch_.load(); !(isReady = ready()); epoch = epoch_.load())
+    {
+        auto remaining = std::chrono::nanoseconds(deadline - std::chrono::steady_clock::now());
+        if (remaining.count() <= 0)
+            break;
+        park(epoch, &remaining);
+    }
+    parkedCount_.fetch_sub(1);
+    return isReady;
+}
@@ -5,6 +5,7 @@
 
 #include <atomic>
 #include <cstdint>
+#include <chrono>
 #include <utility>
 #include <memory>
 
@@ -15,6 +16,8 @@ namespace bcpp::implementation
     template <synchronization_mode T>
     class work_contract_group;
 
+    class reactor;
+
     
     template <synchronization_mode T>
     class alignas(64) work_contract :
@@ -39,6 +42,25 @@ namespace bcpp::implementation
 
         void schedule();
 
+        // schedule once the duration has elapsed (or the time point is reached)
+        template <typename rep, typename period>
+        void schedule_after
+        (
+            std::chrono::duration<rep, period>
+        );
+
+        void schedule_at
+        (
+            std::chrono::steady_clock::time_point
+        );
+
+        // schedule every period, starting one period from now, until released
+        template <typename rep, typename period>
+        void schedule_every
+        (
+            std::chrono::duration<rep, period>
+        );
+
         bool release();
 
         bool deschedule();
@@ -47,26 +69,26 @@ namespace bcpp::implementation
 
         explicit operator bool() const;
 
+        id_type get_id() const;
+
     private:
 
         friend class work_contract_group<T>;
+        friend class reactor;
         using work_contract_group_type = work_contract_group<T>;
 
         work_contract
         (
             work_contract_group_type *, 
-            std::shared_ptr<typename work_contract_group_type::release_token>,
             id_type,
             initial_state = initial_state::unscheduled
         );
 
-        id_type get_id() const;
-
-        work_contract_group_type *   owner_{};
-
-        std::atomic<std::shared_ptr<typename work_contract_group_type::release_token>> releaseToken_;
+        std::atomic<work_contract_group_type *>     owner_{};
 
-        id_type                 id_{};
+        // the id carries the generation of the contract's slot at the time the contract
+        // was created.  the contract is valid while that generation is current.
+        id_type                                     id_{};
 
     }; // class work_contract
 
@@ -89,14 +111,15 @@ template <bcpp::synchronization_mode T>
 inline bcpp::implementation::work_contract<T>::work_contract
 (
     work_contract_group_type * owner,
-    std::shared_ptr<typename work_contract_group_type::release_token> releaseToken, 
     id_type id,
     initial_state initialState
 ):
     owner_(owner),
-    releaseToken_(releaseToken),
     id_(id)
 {
+    if constexpr (handle_tracking_enabled)
+        if (owner != nullptr)
+            owner->handleCount_.fetch_add(1, std::memory_order_relaxed);
     if (initialState == initial_state::scheduled)
         schedule();
 }
@@ -108,11 +131,9 @@ inline bcpp::implementation::work_contract<T>::work_contract
 (
     work_contract && other
 ):
-    owner_(other.owner_),
-    releaseToken_(other.releaseToken_.exchange(nullptr)),
+    owner_(other.owner_.exchange(nullptr)),
     id_(other.id_)
 {
-    other.owner_ = {};
     other.id_ = {};
 }
 
@@ -128,10 +149,8 @@ inline auto bcpp::implementation::work_contract<T>::operator =
     {
         release();
 
-        owner_ = other.owner_;
         id_ = other.id_;
-        releaseToken_ = other.releaseToken_.exchange(nullptr);
-        other.owner_ = {};
+        owner_ = other.owner_.exchange(nullptr);
         other.id_ = {};
     }
     return *this;
@@ -164,7 +183,45 @@ inline void bcpp::implementation::work_contract<T>::schedule
 (
 )
 {
-    owner_->schedule(id_);
+    owner_.load(std::memory_order_relaxed)->schedule(id_);
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+template <typename rep, typename period>
+inline void bcpp::implementation::work_contract<T>::schedule_after
+(
+    std::chrono::duration<rep, period> duration
+)
+{
+    schedule_at(std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(duration));
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline void bcpp::implementation::work_contract<T>::schedule_at
+(
+    std::chrono::steady_clock::time_point when
+)
+{
+    if (auto owner = owner_.load(std::memory_order_relaxed); owner)
+        owner->schedule_at(id_, when);
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+template <typename rep, typename period>
+inline void bcpp::implementation::work_contract<T>::schedule_every
+(
+    std::chrono::duration<rep, period> interval
+)
+{
+    auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(interval);
+    if (auto owner = owner_.load(std::memory_order_relaxed); owner)
+        owner->schedule_every(id_, nanoseconds, std::chrono::steady_clock::now() + nanoseconds);
 }
 
 
@@ -174,11 +231,11 @@ inline bool bcpp::implementation::work_contract<T>::release
 (
 )
 {
-    if (auto releaseToken = releaseToken_.exchange(nullptr); releaseToken)
+    if (auto owner = owner_.exchange(nullptr); owner)
     {
-        releaseToken->schedule(*this);
-        owner_ = {};
-        return true;
+        if constexpr (handle_tracking_enabled)
+            owner->handleCount_.fetch_sub(1, std::memory_order_relaxed);
+        return owner->release(id_);
     }
     return false;
 }
@@ -190,8 +247,8 @@ inline bool bcpp::implementation::work_contract<T>::is_valid
 (
 ) const
 {
-    if (auto releaseToken = releaseToken_.load(); releaseToken)
-        return releaseToken->is_valid();
+    if (auto owner = owner_.load(std::memory_order_relaxed); owner)
+        return owner->is_valid(id_);
     return false;
 }
 
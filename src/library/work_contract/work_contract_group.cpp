@@ -1,25 +1,28 @@
 #include "./work_contract_group.h"
 
+#include <algorithm>
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+bcpp::implementation::work_contract_group<T>::work_contract_group
+(
+):
+    work_contract_group(default_capacity)
+{
+}
+
 
 //=============================================================================
 template <bcpp::synchronization_mode T>
 bcpp::implementation::work_contract_group<T>::work_contract_group
 (
+    // capacity is the initial capacity.  the group grows on demand should
+    // more contracts be created than the current capacity allows.
     std::uint64_t capacity
 ):
-    subTreeCount_(minimum_power_of_two((capacity + (signal_tree_type::capacity - 1)) / signal_tree_type::capacity)),
-    subTreeMask_(subTreeCount_ - 1),
-    subTreeShift_(minimum_bit_count(signal_tree_type::capacity - 1)),
-    signalTree_(subTreeCount_),
-    available_(subTreeCount_),
-    contracts_(subTreeCount_ * signal_tree_type::capacity),
-    release_(contracts_.size()),
-    exception_(contracts_.size()),
-    releaseToken_(subTreeCount_ * signal_tree_type::capacity)
+    work_contract_group(capacity, 1)
 {
-    for (auto & subtree : available_)
-        for (auto i = 0ull; i < signal_tree_type::capacity; ++i)
-            subtree.set(i);
 }
 
 
@@ -27,9 +30,62 @@ bcpp::implementation::work_contract_group<T>::work_contract_group
 template <bcpp::synchronization_mode T>
 bcpp::implementation::work_contract_group<T>::work_contract_group
 (
+    // strict priority bands.  workers always select from the highest priority 
+    // (lowest numbered) non empty band.  initial capacity is shared evenly by the bands.
+    // each execution lane starts with the same capacity as each band.
+    std::uint64_t capacity,
+    std::uint64_t bandCount,
+    lane_configuration laneConfiguration
 ):
-    work_contract_group(default_capacity)
+    bandCount_(std::clamp<std::uint64_t>(bandCount, 1, max_band_count)),
+    laneCount_(std::min<std::uint64_t>(laneConfiguration.laneCount_, max_band_count - bandCount_)),
+    stealAfter_(std::chrono::duration_cast<std::chrono::nanoseconds>(laneConfiguration.stealAfter_).count()),
+    trackNonEmptySubTrees_((bandCount_ + laneCount_) > 1),
+    bands_(std::make_unique<band []>(bandCount_ + laneCount_)),
+    lanes_(std::make_unique<lane_state []>(laneCount_)),
+    initialSubTreeCount_(minimum_power_of_two(std::min<std::uint64_t>((((capacity + bandCount_ - 1) / bandCount_) + (signal_tree_type::capacity - 1)) / signal_tree_type::capacity, max_sub_tree_count))),
+    initialSubTreeShift_(std::countr_zero(initialSubTreeCount_))
+{
+    for (auto i = 0ull; i < (bandCount_ + laneCount_); ++i)
+        grow(bands_[i], 0);
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+bcpp::implementation::work_contract_group<T>::work_contract_group
+(
+    // weighted priority bands.  while bands are saturated band n is tried first in
+    // proportion to bandWeights[n].  otherwise workers fall back to the highest 
+    // priority non empty band.  an empty bandWeights is a single band with a weight of 1.
+    std::uint64_t capacity,
+    std::vector<std::uint64_t> const & bandWeights,
+    lane_configuration laneConfiguration
+):
+    work_contract_group(capacity, bandWeights.size(), laneConfiguration)
 {
+    // smooth weighted round robin so that the schedule interleaves bands
+    // rather than running each band's share back to back.
+    auto weight = [&](auto bandIndex) -> std::int64_t
+            {
+                return (bandIndex < bandWeights.size()) ? std::max<std::uint64_t>(bandWeights[bandIndex], 1) : 1;
+            };
+    std::vector<std::int64_t> current(bandCount_, 0);
+    std::int64_t totalWeight = 0;
+    for (auto i = 0ull; i < bandCount_; ++i)
+        totalWeight += weight(i);
+    for (auto n = 0; n < totalWeight; ++n)
+    {
+        auto selected = 0ull;
+        for (auto i = 0ull; i < bandCount_; ++i)
+        {
+            current[i] += weight(i);
+            if (current[i] > current[selected])
+                selected = i;
+        }
+        current[selected] -= totalWeight;
+        bandSchedule_.push_back(selected);
+    }
 }
 
 
@@ -39,7 +95,10 @@ bcpp::implementation::work_contract_group<T>::~work_contract_group
 (
 )
 {
+    if constexpr (handle_tracking_enabled)
+        assert((handleCount_.load() == 0) && "work_contract outlived its work_contract_group");
     stop();
+    release_thread_state_slot(threadStateSlot_);
 }
 
 
@@ -51,17 +110,26 @@ void bcpp::implementation::work_contract_group<T>::stop
 {
     if (bool wasRunning = !stopped_.exchange(true); wasRunning)
     {
-        for (auto & releaseToken : releaseToken_)
-            if ((bool)releaseToken)
-                releaseToken->orphan();
+        {
+            // advance the generation of every contract so that all existing 
+            // work_contracts become invalid
+            std::lock_guard lockGuard(mutex_);
+            for (auto b = 0ull; b < (bandCount_ + laneCount_); ++b)
+                for (auto i = 0ull; i < bands_[b].segmentCount_; ++i)
+                    for (auto & contract : bands_[b].segments_[i]->contracts_)
+                        contract.flags_ += generation_increment;
+            if (timerServiceOwner_)
+                timerServiceOwner_->stop();
+        }
         if constexpr (mode == synchronization_mode::blocking)
         {
             // this addresses the problem of stopping the group while worker threads
             // are waiting indefinitely for a contract to be scheduled.  Since
             // the group is stopped no such scheduling will ever happen so we
             // give any waiting worker threads a chance to give up the wait now.
-            std::unique_lock uniqueLock(mutex_);
             waitableState_.notify_all();
+            for (auto i = 0ull; i < laneCount_; ++i)
+                lanes_[i].waitableState_.notify_all();
         }
     }
 }
@@ -71,22 +139,60 @@ void bcpp::implementation::work_contract_group<T>::stop
 template <bcpp::synchronization_mode T>
 auto bcpp::implementation::work_contract_group<T>::get_available_contract
 (
+    priority_band priorityBand
 ) -> work_contract_id
 {
-    for (auto i = 0ull; i < available_.size(); ++i)
+    auto bandIndex = static_cast<std::uint64_t>(priorityBand);
+    if (bandIndex >= (bandCount_ + laneCount_))
+        return ~0ull;
+    auto & band = bands_[bandIndex];
+    while (true)
     {
-        auto subTreeIndex (nextAvailableTreeIndex_++ & subTreeMask_);
-        if (!available_[subTreeIndex].empty())
+        auto subTreeCount = band.subTreeCount_.load(std::memory_order_acquire);
+        for (auto i = 0ull; i < subTreeCount; ++i)
         {
-            if (auto [signalIndex, _] = available_[subTreeIndex].select<largest_child_selector>(0); signalIndex != ~0ull)
+            auto subTreeIndex (band.nextAvailableTreeIndex_++ & (subTreeCount - 1));
+            auto & segment = get_segment(band, subTreeIndex);
+            if (auto & available = segment.available_[subTreeIndex - segment.firstSubTreeIndex_]; !available.empty())
             {
-                work_contract_id workContractId(subTreeIndex * signal_tree_capacity);
-                workContractId += signalIndex;
-                return workContractId;
+                if (auto [signalIndex, _] = available.template select<signal_tree::largest_child_selector>(0); signalIndex != ~0ull)
+                {
+                    work_contract_id workContractId((bandIndex << band_shift) | (subTreeIndex * signal_tree_capacity));
+                    workContractId += signalIndex;
+                    return workContractId;
+                }
             }
         }
+        if (!grow(band, subTreeCount))
+            return ~0ull; 
     }
-    return ~0ull; 
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+bool bcpp::implementation::work_contract_group<T>::grow
+(
+    // add a segment to the band which doubles the number of subtrees in that band.  
+    // the new segment is fully constructed before the new subtree count is published 
+    // so threads executing contracts never observe a partially constructed segment 
+    // and never need the lock. returns false if the band can not grow any further
+    // (its contract indices would no longer fit within contract_index_mask).
+    band & band,
+    std::uint64_t observedSubTreeCount
+)
+{
+    std::lock_guard lockGuard(mutex_);
+    auto subTreeCount = band.subTreeCount_.load(std::memory_order_relaxed);
+    if (subTreeCount != observedSubTreeCount)
+        return true; // another thread has already grown the band
+    auto additionalSubTreeCount = (band.segmentCount_ == 0) ? initialSubTreeCount_ : subTreeCount;
+    if ((band.segmentCount_ == max_segment_count) || ((subTreeCount + additionalSubTreeCount) > max_sub_tree_count) || (stopped_))
+        return false;
+    auto bandIndex = static_cast<std::uint64_t>(&band - bands_.get());
+    band.segments_[band.segmentCount_++] = std::make_unique<segment>(bandIndex, subTreeCount, additionalSubTreeCount);
+    band.subTreeCount_.store(subTreeCount + additionalSubTreeCount, std::memory_order_release);
+    return true;
 }
 
 
@@ -98,15 +204,19 @@ void bcpp::implementation::work_contract_group<T>::erase_contract
     work_contract_id contractId
 ) noexcept
 {
-    auto & contract = contracts_[contractId];
+    auto [treeIndex, signalIndex] = get_tree_and_signal_index(contractId);
+    auto & segment = get_segment(contractId);
+    auto index = (contractId - segment.firstContractId_);
+    auto & contract = segment.contracts_[index];
     contract.work_ = nullptr;
-    release_[contractId] = nullptr;
-    exception_[contractId] = nullptr;
-    if (auto releaseToken = std::exchange(releaseToken_[contractId], nullptr); releaseToken)
-        releaseToken->orphan(); // mark as invalid
+    segment.callbacks_[index].reset();
+    // advance the generation (mark all work_contracts for this slot as invalid) and 
+    // clear the state flags
+    auto flags = contract.flags_.load();
+    while (!contract.flags_.compare_exchange_weak(flags, (flags & generation_mask) + generation_increment))
+        ;
 
-    auto [treeIndex, signalIndex] = get_tree_and_signal_index(contractId);
-    available_[treeIndex].set(signalIndex);
+    segment.available_[treeIndex - segment.firstSubTreeIndex_].set(signalIndex);
 }
 
 
@@ -118,14 +228,14 @@ void bcpp::implementation::work_contract_group<T>::process_exception
     std::exception_ptr exception
 )
 {
-    if (exception_[contractId])
+    increment_statistic(statistics_counter::exceptions);
+    trace(trace_event_type::exception, contractId);
+    // contracts without an exception function discard the exception
+    auto & segment = get_segment(contractId);
+    if (auto & callbacks = segment.callbacks_[contractId - segment.firstContractId_]; callbacks && callbacks->exception_)
     {
     //    work_contract_token workContractToken(contractId, *this);
-        exception_[contractId](/*workContractToken, */exception);
-    }
-    else
-    {
-        std::rethrow_exception(exception);
+        callbacks->exception_(/*workContractToken, */exception);
     }
 }
 
@@ -139,10 +249,14 @@ void bcpp::implementation::work_contract_group<T>::process_release
     work_contract_id contractId
 )
 {
+    increment_statistic(statistics_counter::releases);
+    trace(trace_event_type::release, contractId);
     auto_erase_contract autoEraseContract(contractId, *this);
     try
     {
-        release_[contractId]();
+        auto & segment = get_segment(contractId);
+        if (auto & callbacks = segment.callbacks_[contractId - segment.firstContractId_]; callbacks && callbacks->release_)
+            callbacks->release_();
     }
     catch (std::exception const & exception)
     {
@@ -153,26 +267,43 @@ void bcpp::implementation::work_contract_group<T>::process_release
 
 //=============================================================================
 template <bcpp::synchronization_mode T>
-bcpp::implementation::work_contract_group<T>::release_token::release_token
+bool bcpp::implementation::work_contract_group<T>::schedule_at
 (
-    work_contract_group * workContractGroup
-):
-    workContractGroup_(workContractGroup)
+    // schedule the contract once the specified time has been reached.  returns false
+    // if the contract is not valid.  the contract is scheduled as per schedule(id) and
+    // so a contract which is already scheduled is not scheduled twice.
+    work_contract_id contractId,
+    std::chrono::steady_clock::time_point when
+)
 {
+    if (!is_valid(contractId))
+        return false;
+    if (auto timerService = get_timer_service(); timerService != nullptr)
+    {
+        timerService->schedule_at(contractId, when);
+        return true;
+    }
+    return false;
 }
 
 
 //=============================================================================
 template <bcpp::synchronization_mode T>
-bool bcpp::implementation::work_contract_group<T>::release_token::schedule
+bool bcpp::implementation::work_contract_group<T>::schedule_every
 (
-    work_contract_type const & workContract
+    // schedule the contract at first and then every period after that.  each
+    // deadline is the previous deadline plus period so the schedule does not drift.
+    // stops once the contract is released.
+    work_contract_id contractId,
+    std::chrono::nanoseconds period,
+    std::chrono::steady_clock::time_point first
 )
 {
-    std::lock_guard lockGuard(mutex_);
-    if (auto workContractGroup = std::exchange(workContractGroup_, nullptr); workContractGroup != nullptr)
+    if (!is_valid(contractId))
+        return false;
+    if (auto timerService = get_timer_service(); timerService != nullptr)
     {
-        workContractGroup->release(workContract.get_id());
+        timerService->schedule_every(contractId, first, period);
         return true;
     }
     return false;
@@ -181,23 +312,320 @@ bool bcpp::implementation::work_contract_group<T>::release_token::schedule
 
 //=============================================================================
 template <bcpp::synchronization_mode T>
-void bcpp::implementation::work_contract_group<T>::release_token::orphan
+auto bcpp::implementation::work_contract_group<T>::get_timer_service
 (
-)
+    // the timer service is created on first use.  null once the group is stopped.
+) -> timer_service *
 {
+    if (auto timerService = timerService_.load(std::memory_order_acquire); timerService != nullptr) [[likely]]
+        return timerService;
+
     std::lock_guard lockGuard(mutex_);
-    workContractGroup_ = nullptr;
+    if (stopped_)
+        return nullptr;
+    if (!timerServiceOwner_)
+    {
+        static constexpr bool(*schedule)(work_contract_id, void *) = [](work_contract_id contractId, void * group)
+            {
+                return reinterpret_cast<work_contract_group<T> *>(group)->schedule(contractId);
+            };
+        timerServiceOwner_ = std::make_unique<timer_service>(schedule, this);
+        timerService_.store(timerServiceOwner_.get(), std::memory_order_release);
+    }
+    return timerServiceOwner_.get();
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+auto bcpp::implementation::work_contract_group<T>::get_schedule_latency
+(
+    // merge the histograms of every thread.  samples recorded concurrently may or 
+    // may not be included.
+) const -> latency_histogram
+requires (latency_instrumentation_enabled)
+{
+    latency_histogram scheduleLatency;
+    std::lock_guard lockGuard(threadStateMutex_);
+    for (auto const & [threadId, threadState] : threadStates_)
+        scheduleLatency.merge(threadState->latency_);
+    return scheduleLatency;
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+void bcpp::implementation::work_contract_group<T>::reset_schedule_latency
+(
+    // samples recorded concurrently with the reset may be lost
+)
+requires (latency_instrumentation_enabled)
+{
+    std::lock_guard lockGuard(threadStateMutex_);
+    for (auto & [threadId, threadState] : threadStates_)
+        threadState->latency_.reset();
 }
 
 
 //=============================================================================
 template <bcpp::synchronization_mode T>
-bool bcpp::implementation::work_contract_group<T>::release_token::is_valid
+auto bcpp::implementation::work_contract_group<T>::get_statistics
 (
-) const
+    // sum the counters of every thread.  counts which are being updated concurrently
+    // may or may not be included.  scheduled contracts are counted from the contracts'
+    // flags.
+) const -> group_statistics
+requires (statistics_enabled)
 {
+    std::array<std::uint64_t, static_cast<std::uint64_t>(statistics_counter::count)> totals{};
+    {
+        std::lock_guard lockGuard(threadStateMutex_);
+        for (auto const & [threadId, threadState] : threadStates_)
+            for (auto i = 0ull; i < totals.size(); ++i)
+                totals[i] += threadState->statistics_.load(static_cast<statistics_counter>(i));
+    }
+    auto total = [&](statistics_counter counter){return totals[static_cast<std::uint64_t>(counter)];};
+
+    group_statistics statistics;
+    statistics.executions_ = total(statistics_counter::executions);
+    statistics.emptyPolls_ = total(statistics_counter::empty_polls);
+    statistics.releases_ = total(statistics_counter::releases);
+    statistics.exceptions_ = total(statistics_counter::exceptions);
+    statistics.scheduleCalls_ = total(statistics_counter::schedule_calls);
+    statistics.signalsSet_ = total(statistics_counter::signals_set);
+    statistics.selects_ = total(statistics_counter::selects);
+    statistics.subTreesScanned_ = total(statistics_counter::subtrees_scanned);
+    statistics.selectRetries_ = total(statistics_counter::select_retries);
+    auto created = total(statistics_counter::contracts_created);
+    statistics.liveContracts_ = (created > statistics.releases_) ? (created - statistics.releases_) : 0;
+
     std::lock_guard lockGuard(mutex_);
-    return ((bool)workContractGroup_);
+    for (auto bandIndex = 0ull; bandIndex < (bandCount_ + laneCount_); ++bandIndex)
+        for (auto segmentIndex = 0ull; segmentIndex < bands_[bandIndex].segmentCount_; ++segmentIndex)
+            for (auto const & contract : bands_[bandIndex].segments_[segmentIndex]->contracts_)
+                statistics.scheduledContracts_ += ((contract.flags_.load(std::memory_order_relaxed) & contract::schedule_flag) != 0);
+    return statistics;
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+auto bcpp::implementation::work_contract_group<T>::get_trace
+(
+    // threads continue to record while the trace is taken
+) const -> std::vector<trace_event>
+requires (tracing_enabled)
+{
+    std::vector<trace_event> events;
+    {
+        std::lock_guard lockGuard(threadStateMutex_);
+        for (auto i = 0ull; i < threadStates_.size(); ++i)
+            threadStates_[i].second->trace_.copy_to(events, static_cast<std::uint32_t>(i));
+    }
+    std::stable_sort(events.begin(), events.end(), [](auto const & a, auto const & b){return (a.time_ < b.time_);});
+    return events;
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+std::uint64_t bcpp::implementation::work_contract_group<T>::next_instance_id
+(
+    // identifies the group to the thread local state cache.  unlike the group's 
+    // address (or cache slot), an id is never reused by a later group.
+) noexcept
+{
+    static std::atomic<std::uint64_t> nextInstanceId{1};
+    return nextInstanceId.fetch_add(1, std::memory_order_relaxed);
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+auto bcpp::implementation::work_contract_group<T>::register_thread_state
+(
+    // the calling thread's first use of this group.  create its state and cache it.
+) -> thread_state &
+{
+    thread_state * threadState = nullptr;
+    {
+        std::lock_guard lockGuard(threadStateMutex_);
+        auto iter = std::find_if(threadStates_.begin(), threadStates_.end(), 
+                [](auto const & entry){return (entry.first == std::this_thread::get_id());});
+        if (iter == threadStates_.end())
+            iter = threadStates_.insert(iter, {std::this_thread::get_id(), std::make_unique<thread_state>()});
+        threadState = iter->second.get();
+    }
+    if (threadStateSlot_ >= tls_threadStates_.size())
+        tls_threadStates_.resize(threadStateSlot_ + 1);
+    tls_threadStates_[threadStateSlot_] = {instanceId_, threadState};
+    return *threadState;
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+auto bcpp::implementation::work_contract_group<T>::get_thread_state_slots
+(
+) noexcept -> thread_state_slots &
+{
+    static thread_state_slots threadStateSlots;
+    return threadStateSlots;
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+std::uint64_t bcpp::implementation::work_contract_group<T>::acquire_thread_state_slot
+(
+    // slots are reused so that each thread's cache is only as large as the greatest
+    // number of groups which have been alive at once
+)
+{
+    auto & threadStateSlots = get_thread_state_slots();
+    std::lock_guard lockGuard(threadStateSlots.mutex_);
+    if (threadStateSlots.free_.empty())
+        return threadStateSlots.next_++;
+    auto slot = threadStateSlots.free_.back();
+    threadStateSlots.free_.pop_back();
+    return slot;
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+void bcpp::implementation::work_contract_group<T>::release_thread_state_slot
+(
+    // threads' cache entries for the slot are left as they are.  they no longer match
+    // the owner (instance id) of any group which later acquires the slot.
+    std::uint64_t slot
+) noexcept
+{
+    auto & threadStateSlots = get_thread_state_slots();
+    std::lock_guard lockGuard(threadStateSlots.mutex_);
+    threadStateSlots.free_.push_back(slot);
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+auto bcpp::implementation::work_contract_group<T>::make_parallel
+(
+    // mark a newly created (and as yet unscheduled) contract as parallel
+    work_contract_type workContract,
+    max_concurrency maxConcurrency,
+    work_contract_type::initial_state initialState
+) -> work_contract_type
+{
+    if (workContract.is_valid())
+    {
+        auto concurrencyLimit = std::clamp<std::uint64_t>(static_cast<std::uint64_t>(maxConcurrency), 1, contract::parallel_field_mask);
+        get_contract(workContract.get_id()).flags_ |= (contract::parallel_flag | (concurrencyLimit << contract::concurrency_limit_shift));
+        if (initialState == work_contract_type::initial_state::scheduled)
+            workContract.schedule();
+    }
+    return workContract;
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+void bcpp::implementation::work_contract_group<T>::process_parallel_contract
+(
+    // the execute flag of a parallel contract is only held while a selection is being
+    // admitted or while the contract is saturated (executions in progress at the limit).
+    // so scheduling a parallel contract while it is executing below its limit signals
+    // it again and another worker is admitted.  flags are as returned by the selection.
+    work_contract_id contractId,
+    state_flags flags
+)
+{
+    if ((flags & contract::release_flag) == contract::release_flag)
+    {
+        // the release is processed once no executions remain.  either now or by 
+        // the last execution to leave.
+        if (leave_parallel_contract(contractId, contract::execute_flag))
+            process_release(contractId);
+        return;
+    }
+
+    // admit this execution.  keep the execute flag if the contract is now saturated.
+    auto & contract = get_contract(contractId);
+    auto expected = contract.flags_.load();
+    auto desired = expected;
+    do
+    {
+        desired = (expected + contract::executor_increment);
+        auto executorCount = ((desired >> contract::executor_count_shift) & contract::parallel_field_mask);
+        auto concurrencyLimit = ((desired >> contract::concurrency_limit_shift) & contract::parallel_field_mask);
+        if (executorCount < concurrencyLimit)
+            desired -= contract::execute_flag;
+    } while (!contract.flags_.compare_exchange_weak(expected, desired));
+    // scheduled while this selection was being admitted.  admit another.
+    if ((desired & (contract::execute_flag | contract::schedule_flag)) == contract::schedule_flag)
+        set_contract_signal(contractId);
+
+    static constexpr void(*release)(work_contract_id, void *) = [](work_contract_id contractId, void * group) noexcept
+        {
+            reinterpret_cast<work_contract_group<T> *>(group)->release_unchecked(contractId);
+        };
+    static constexpr void(*schedule)(work_contract_id, void *) = [](work_contract_id contractId, void * group) noexcept
+        {
+            reinterpret_cast<work_contract_group<T> *>(group)->schedule_unchecked(contractId);
+        };
+    increment_statistic(statistics_counter::executions);
+    trace(trace_event_type::start, contractId);
+    {
+        bcpp::this_contract thisContract(contractId, this, release, schedule);
+        try
+        {
+            contract.work_();
+        }
+        catch (...)
+        {
+            process_exception(contractId, std::current_exception());
+        }
+    }
+    trace(trace_event_type::end, contractId);
+    if (leave_parallel_contract(contractId, contract::executor_increment))
+        process_release(contractId);
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+bool bcpp::implementation::work_contract_group<T>::leave_parallel_contract
+(
+    // clear either an execution in progress (executor_increment) or a held execute 
+    // flag (execute_flag) from a parallel contract.  returns true if the contract has
+    // been released and nothing remains in progress (the caller processes the release).
+    work_contract_id contractId,
+    state_flags flagsToClear
+) noexcept
+{
+    auto & contract = get_contract(contractId);
+    auto expected = contract.flags_.load();
+    auto desired = expected;
+    do
+    {
+        desired = (expected - flagsToClear);
+        auto executorCount = ((expected >> contract::executor_count_shift) & contract::parallel_field_mask);
+        auto concurrencyLimit = ((expected >> contract::concurrency_limit_shift) & contract::parallel_field_mask);
+        if ((flagsToClear == contract::executor_increment) && (executorCount == concurrencyLimit) && 
+                ((expected & contract::execute_flag) == contract::execute_flag))
+            desired -= contract::execute_flag; // no longer saturated
+    } while (!contract.flags_.compare_exchange_weak(expected, desired));
+
+    // the schedule flag was set while the execute flag was held (so nothing was signaled)
+    auto executeFlagCleared = (((expected ^ desired) & contract::execute_flag) == contract::execute_flag);
+    if ((executeFlagCleared) && ((desired & contract::schedule_flag) == contract::schedule_flag))
+    {
+        set_contract_signal(contractId);
+        return false;
+    }
+    static auto constexpr release_state_mask = (contract::release_flag | contract::execute_flag | contract::schedule_flag | 
+            (contract::parallel_field_mask << contract::executor_count_shift));
+    return ((desired & release_state_mask) == contract::release_flag);
 }
 
 
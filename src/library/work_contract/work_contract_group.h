@@ -1,7 +1,16 @@
 #pragma once
 
 #include "./work_contract_id.h"
+#include "./priority_band.h"
+#include "./execution_lane.h"
+#include "./max_concurrency.h"
+#include "./inline_function.h"
 #include "./work_contract_this.h"
+#include "./waitable_state.h"
+#include "./timer_service.h"
+#include "./latency_histogram.h"
+#include "./group_statistics.h"
+#include "./execution_trace.h"
 
 #include <include/signal_tree.h>
 #include <include/synchronization_mode.h>
@@ -12,10 +21,18 @@
 #include <cstdint>
 #include <atomic>
 #include <mutex>
-#include <condition_variable>
 #include <functional>
 #include <concepts>
 #include <bit>
+#include <chrono>
+#include <array>
+#include <vector>
+#include <span>
+#include <type_traits>
+#include <thread>
+#include <utility>
+#include <algorithm>
+#include <cassert>
 
 
 namespace bcpp::implementation
@@ -23,56 +40,30 @@ namespace bcpp::implementation
 
     template <synchronization_mode> class work_contract;
 
+    template <synchronization_mode> class schedule_operation;
+
+    // a work_contract refers directly to its group's storage so it must not outlive
+    // the group.  debug builds count each group's live work_contracts and assert
+    // that none remain when the group is destroyed.
+    #if defined(NDEBUG)
+        static bool constexpr handle_tracking_enabled = false;
+    #else
+        static bool constexpr handle_tracking_enabled = true;
+    #endif
+
 
     template <synchronization_mode T>
-    class work_contract_group final :
+    class work_contract_group :
         non_copyable,
         non_movable
     {
     public:
 
-        //============================================================================= 
-        template <std::uint64_t total_counters, std::uint64_t bits_per_counter>
-        struct largest_child_selector
-        {
-            inline auto operator()
-            (
-                std::uint64_t,
-                std::uint64_t counters
-            ) const noexcept -> signal_index
-            {
-                if constexpr (bits_per_counter == 1)
-                {
-                    return (counters > 0) ? std::countl_zero(counters) : ~0ull;
-                }
-                else
-                {
-                    // this routine is only called to select new contract ids.  but we could improve speed here
-                    // with a expression fold as total counters is never more than 8 and often 4 or 2.
-                    auto selected = ~0ull;
-                    auto max = 0ull;
-                    /*static*/ auto /*constexpr*/ counter_mask = ((1ull << bits_per_counter) - 1);
-                    for (auto i = 0ull; i < total_counters; ++i)
-                    {
-                        if ((counters & counter_mask) > max)
-                        {
-                            max = (counters & counter_mask);
-                            selected = i;
-                        }
-                        counters >>= bits_per_counter;
-                    }
-                    return (total_counters - selected - 1);
-                }
-            }
-        };
-
         static auto constexpr mode = T;
         using work_contract_type = work_contract<mode>;
 
         static auto constexpr default_capacity = 512;
 
-        class release_token;
-
         work_contract_group();
 
         work_contract_group
@@ -80,6 +71,20 @@ namespace bcpp::implementation
             std::uint64_t
         );
 
+        work_contract_group
+        (
+            std::uint64_t,
+            std::uint64_t,
+            lane_configuration = {}
+        );
+
+        work_contract_group
+        (
+            std::uint64_t,
+            std::vector<std::uint64_t> const &,
+            lane_configuration = {}
+        );
+
         ~work_contract_group();
 
         work_contract_type create_contract
@@ -103,13 +108,119 @@ namespace bcpp::implementation
             work_contract_type::initial_state = work_contract_type::initial_state::unscheduled
         );
 
+        work_contract_type create_contract
+        (
+            priority_band,
+            std::invocable auto &&,
+            work_contract_type::initial_state = work_contract_type::initial_state::unscheduled
+        );
+
+        work_contract_type create_contract
+        (
+            priority_band,
+            std::invocable auto &&,
+            std::invocable auto &&,
+            work_contract_type::initial_state = work_contract_type::initial_state::unscheduled
+        );
+
+        work_contract_type create_contract
+        (
+            priority_band,
+            std::invocable auto &&,
+            std::invocable auto &&,
+            std::invocable<std::exception_ptr> auto &&,
+            work_contract_type::initial_state = work_contract_type::initial_state::unscheduled
+        );
+
+        work_contract_type create_contract
+        (
+            execution_lane,
+            std::invocable auto &&,
+            work_contract_type::initial_state = work_contract_type::initial_state::unscheduled
+        );
+
+        work_contract_type create_contract
+        (
+            execution_lane,
+            std::invocable auto &&,
+            std::invocable auto &&,
+            work_contract_type::initial_state = work_contract_type::initial_state::unscheduled
+        );
+
+        work_contract_type create_contract
+        (
+            execution_lane,
+            std::invocable auto &&,
+            std::invocable auto &&,
+            std::invocable<std::exception_ptr> auto &&,
+            work_contract_type::initial_state = work_contract_type::initial_state::unscheduled
+        );
+
+        work_contract_type create_contract
+        (
+            max_concurrency,
+            std::invocable auto &&,
+            work_contract_type::initial_state = work_contract_type::initial_state::unscheduled
+        );
+
+        work_contract_type create_contract
+        (
+            max_concurrency,
+            std::invocable auto &&,
+            std::invocable auto &&,
+            work_contract_type::initial_state = work_contract_type::initial_state::unscheduled
+        );
+
+        work_contract_type create_contract
+        (
+            max_concurrency,
+            std::invocable auto &&,
+            std::invocable auto &&,
+            std::invocable<std::exception_ptr> auto &&,
+            work_contract_type::initial_state = work_contract_type::initial_state::unscheduled
+        );
+
         std::uint64_t execute_next_contract();
 
         std::uint64_t execute_next_contract
         (
             std::uint64_t & 
         );
+
+        std::uint64_t execute_next_contract
+        (
+            priority_band,
+            std::uint64_t & 
+        );
+
+        std::uint64_t execute_next_contract
+        (
+            execution_lane
+        );
+
+        std::uint64_t execute_next_contract
+        (
+            execution_lane,
+            std::uint64_t & 
+        );
         
+        std::uint64_t execute_next_contracts
+        (
+            std::uint64_t
+        );
+
+        std::uint64_t execute_next_contracts
+        (
+            std::uint64_t,
+            std::uint64_t & 
+        );
+
+        template <typename rep, typename period>
+        std::uint64_t execute_for
+        (
+            std::chrono::duration<rep, period>
+        );
+
         template <typename rep, typename period>
         std::uint64_t execute_next_contract
         (
@@ -125,47 +236,167 @@ namespace bcpp::implementation
 
         void stop();
 
+        void schedule
+        (
+            std::span<work_contract_type>
+        ) noexcept;
+
+        bool schedule
+        (
+            work_contract_id
+        ) noexcept;
+
+        // co_await group.schedule() (see contract_coroutine.h)
+        schedule_operation<mode> schedule() noexcept;
+
+        bool release
+        (
+            work_contract_id
+        ) noexcept;
+
+        bool is_valid
+        (
+            work_contract_id
+        ) const noexcept;
+
+        bool schedule_at
+        (
+            work_contract_id,
+            std::chrono::steady_clock::time_point
+        );
+
+        bool schedule_every
+        (
+            work_contract_id,
+            std::chrono::nanoseconds,
+            std::chrono::steady_clock::time_point
+        );
+
+        std::uint64_t capacity() const;
+
+        std::uint64_t band_count() const;
+
+        std::uint64_t lane_count() const;
+
+        // the schedule to execute latency of this group's contracts, merged over
+        // every thread which has executed them (see latency_histogram.h)
+        latency_histogram get_schedule_latency() const requires (latency_instrumentation_enabled);
+
+        void reset_schedule_latency() requires (latency_instrumentation_enabled);
+
+        // counters summed over every thread which has used the group (see group_statistics.h)
+        group_statistics get_statistics() const requires (statistics_enabled);
+
+        // the buffered events of every thread which has used the group, ordered by time
+        // (see execution_trace.h)
+        std::vector<trace_event> get_trace() const requires (tracing_enabled);
+
+        void set_spin_window
+        (
+            std::chrono::nanoseconds,
+            bool = false
+        ) requires (mode == synchronization_mode::blocking);
+
+        std::chrono::nanoseconds get_spin_window() const requires (mode == synchronization_mode::blocking);
+
     private:
 
         class auto_erase_contract;
         class auto_clear_execute_flag;
         
         friend class work_contract<mode>;
-        friend class release_token;
         friend class auto_erase_contract;
         friend class auto_clear_execute_flag;
 
         using state_flags = std::uint64_t;
 
-        struct alignas(64) contract
+        static auto constexpr contract_size = 64;
+
+        // the work function is stored inline and, together with the flags, fills
+        // the contract's cache line so that executing a contract never allocates
+        using work_function = inline_function<void(), contract_size - sizeof(std::atomic<state_flags>)>;
+        using release_function = inline_function<void(), 64>;
+        using exception_function = inline_function<void(std::exception_ptr), 64>;
+
+        struct no_callback{};
+
+        // cold per contract state.  never touched when executing a contract.
+        // only allocated if a release or exception function is provided.
+        struct contract_callbacks
+        {
+            release_function            release_;
+            exception_function          exception_;
+        };
+
+
+        struct alignas(contract_size) contract
         {
             static auto constexpr release_flag      = 0x00000004ull;
             static auto constexpr execute_flag      = 0x00000002ull;
             static auto constexpr schedule_flag     = 0x00000001ull;
+
+            // parallel contracts only.  bits [8, 16) hold the concurrency limit and
+            // bits [16, 24) the number of executions in progress.
+            static auto constexpr parallel_flag             = 0x00000008ull;
+            static auto constexpr concurrency_limit_shift   = 8;
+            static auto constexpr executor_count_shift      = 16;
+            static auto constexpr executor_increment        = (1ull << executor_count_shift);
+            static auto constexpr parallel_field_mask       = 0xffull;
+
+            // bits [generation_shift, 64) of the flags hold the generation of the slot
         
             std::atomic<state_flags>    flags_;
-            std::function<void()>       work_;
+            work_function               work_;
         };
 
-        void schedule
+        static_assert(sizeof(contract) == contract_size);
+
+        void schedule_unchecked
         (
             work_contract_id 
         ) noexcept;
 
-        void release
+        void release_unchecked
         (
             work_contract_id 
         ) noexcept;        
+
+        state_flags set_flags_if_valid
+        (
+            work_contract_id,
+            state_flags
+        ) noexcept;
         
         void set_contract_signal
         (
             work_contract_id
         ) noexcept;
 
+        void set_contract_signals
+        (
+            work_contract_id,
+            std::uint64_t
+        ) noexcept;
+
         void process_release(work_contract_id);
 
         void process_contract(work_contract_id);
 
+        void process_parallel_contract(work_contract_id, state_flags);
+
+        bool leave_parallel_contract
+        (
+            work_contract_id,
+            state_flags
+        ) noexcept;
+
+        work_contract_type make_parallel
+        (
+            work_contract_type,
+            max_concurrency,
+            work_contract_type::initial_state
+        );
+
         void process_exception(work_contract_id, std::exception_ptr);
 
         void clear_execute_flag
@@ -178,13 +409,46 @@ namespace bcpp::implementation
             work_contract_id
         ) noexcept;
 
-        work_contract_id get_available_contract();
+        struct segment;
+        struct band;
+
+        work_contract_id get_available_contract
+        (
+            priority_band
+        );
+
+        bool grow
+        (
+            band &,
+            std::uint64_t
+        );
 
         std::tuple<std::uint64_t, std::uint64_t> get_tree_and_signal_index
         (
             work_contract_id
         ) const;
 
+        band & get_band
+        (
+            work_contract_id
+        ) const noexcept;
+
+        segment & get_segment
+        (
+            band const &,
+            std::uint64_t
+        ) const noexcept;
+
+        segment & get_segment
+        (
+            work_contract_id
+        ) const noexcept;
+
+        contract & get_contract
+        (
+            work_contract_id
+        ) const noexcept;
+
         // internal signal tree capacity can be tuned for different performance needs
         static auto constexpr minimum_latency_signal_tree_capacity = 64;
         static auto constexpr general_purpose_signal_tree_capacity = 512;
@@ -193,306 +457,1334 @@ namespace bcpp::implementation
         using signal_tree_type = bcpp::signal_tree<default_signal_tree_capacity>;
         static auto constexpr signal_tree_capacity = signal_tree_type::capacity;
 
-        std::uint64_t                                                   subTreeCount_;
+        //=====================================================================
+        // capacity grows by adding segments.  segment zero holds the initial
+        // subtrees and each additional segment doubles the total subtree count
+        // so the total is always a power of two (subtree index can still wrap
+        // with a mask) and the segment holding any subtree is found with a 
+        // single bit_width. segments are never moved nor freed until the group 
+        // is destroyed so references into them remain stable while growing.
+        struct segment
+        {
+            segment
+            (
+                std::uint64_t bandIndex,
+                std::uint64_t firstSubTreeIndex,
+                std::uint64_t subTreeCount
+            ):
+                firstSubTreeIndex_(firstSubTreeIndex),
+                firstContractId_((bandIndex << band_shift) | (firstSubTreeIndex * signal_tree_capacity)),
+                signalTree_(subTreeCount),
+                available_(subTreeCount),
+                contracts_(subTreeCount * signal_tree_capacity),
+                callbacks_(contracts_.size()),
+                scheduleTimes_(latency_instrumentation_enabled ? contracts_.size() : 0)
+            {
+                for (auto & subtree : available_)
+                    for (auto i = 0ull; i < signal_tree_type::capacity; ++i)
+                        subtree.set(i);
+            }
 
-        std::uint64_t                                                   subTreeMask_;
+            std::uint64_t const                                         firstSubTreeIndex_;
+            work_contract_id const                                      firstContractId_;
+            std::vector<signal_tree_type>                               signalTree_;
+            std::vector<signal_tree_type>                               available_;
+            std::vector<contract>                                       contracts_;
+            std::vector<std::unique_ptr<contract_callbacks>>            callbacks_;
+            // latency instrumentation only.  when each contract was last scheduled (tsc)
+            std::vector<std::atomic<std::uint64_t>>                     scheduleTimes_;
+        };
 
-        std::uint64_t                                                   subTreeShift_;
+        static auto constexpr max_segment_count = 32;
 
-        std::vector<signal_tree_type>                                   signalTree_;
+        //=====================================================================
+        // each priority band has its own bank of signal trees and contract 
+        // storage.  the band is encoded in the contract id above band_shift.
+        struct alignas(64) band
+        {
+            std::atomic<std::uint64_t>                                  subTreeCount_{0};
+            std::atomic<std::int64_t>                                   nonEmptySubTreeCount_{0};
+            std::atomic<std::uint64_t>                                  nextAvailableTreeIndex_{0};
+            std::array<std::unique_ptr<segment>, max_segment_count>     segments_;
+            std::uint64_t                                               segmentCount_{0};
+        };
 
-        std::vector<signal_tree_type>                                   available_;
+        // see work_contract_id.h for the layout of the contract id
+        static auto constexpr band_shift = 32;
+        static auto constexpr contract_index_mask = ((1ull << band_shift) - 1);
+        // a band may not grow beyond the number of subtrees whose contract indices
+        // fit within contract_index_mask (the band and generation bits lie above it)
+        static auto constexpr max_sub_tree_count = ((contract_index_mask + 1) / signal_tree_capacity);
+        static auto constexpr max_band_count = 64;
 
-        std::vector<contract>                                           contracts_;
+        // the generation of a contract slot is held in the same bits of both the contract's
+        // flags and the contract's id so an id is validated with a single compare.  the 
+        // generation advances each time the slot is erased (and when the group is stopped) 
+        // which invalidates every id created from the previous generation.
+        static auto constexpr generation_shift = 38;
+        static auto constexpr generation_increment = (1ull << generation_shift);
+        static auto constexpr generation_mask = ~(generation_increment - 1);
+        static auto constexpr invalid_flags = ~0ull;
 
-        std::vector<std::function<void()>>                              release_;
+        static_assert((1ull << (generation_shift - band_shift)) == max_band_count);
+        static_assert((1ull << (max_segment_count - 1)) >= max_sub_tree_count);
 
-        std::vector<std::function<void(std::exception_ptr)>>            exception_;
+        std::uint64_t                                                   bandCount_;
 
-        std::vector<std::shared_ptr<release_token>>                     releaseToken_;
+        // execution lanes are held as additional bands following the priority bands
+        std::uint64_t const                                             laneCount_;
 
-        std::mutex                                                      mutex_;
+        std::int64_t const                                              stealAfter_;
 
-        std::atomic<bool>                                               stopped_{false};
+        // non empty subtrees are counted per band when there is more than one band
+        bool const                                                      trackNonEmptySubTrees_;
 
-        std::atomic<std::uint64_t>                                      nextAvailableTreeIndex_{0};
+        std::unique_ptr<band []>                                        bands_;
 
-        static thread_local std::uint64_t                               tls_biasFlags_;
+        struct alignas(64) lane_state
+        {
+            waitable_state                                              waitableState_;
+            // when the lane's workers last selected from the lane (if stealing is enabled)
+            std::atomic<std::int64_t>                                   lastSelectTime_{0};
+        };
 
-        std::atomic<std::int64_t>                                       nonZeroCounter_{0};
+        std::unique_ptr<lane_state []>                                  lanes_;
 
-        void decrement_non_zero_counter();
-        void increment_non_zero_counter();
+        // weighted mode: the band which each worker tries first is taken in turn from 
+        // this (smoothly interleaved) sequence.  empty when bands are strict priority.
+        std::vector<std::uint8_t>                                       bandSchedule_;
 
-        struct 
-        {
-            std::mutex mutable              mutex_;
-            std::condition_variable mutable conditionVariable_;
+        std::uint64_t const                                             initialSubTreeCount_;
 
-            void notify_all()
-            {
-                std::lock_guard lockGuard(mutex_);
-                conditionVariable_.notify_all();
-            }
+        std::uint64_t const                                             initialSubTreeShift_;
 
-            bool wait(work_contract_group const * owner) const
-            {
-                if (owner->nonZeroCounter_ == 0)
-                {
-                    std::unique_lock uniqueLock(mutex_);
-                    conditionVariable_.wait(uniqueLock, [owner](){return ((owner->nonZeroCounter_ != 0) || (owner->stopped_));});
-                    return (not owner->stopped_);
-                }
-                return true;
-            }
+        std::mutex mutable                                              mutex_;
 
-            bool wait_for
-            (
-                work_contract_group const * owner,
-                std::chrono::nanoseconds duration
-            ) const
-            {                
-                if (owner->nonZeroCounter_ == 0)
-                {
-                    std::unique_lock uniqueLock(mutex_);
-                    auto waitSuccess = conditionVariable_.wait_for(uniqueLock, duration, [owner]() mutable{return ((owner->nonZeroCounter_ != 0) || (owner->stopped_));});
-                    return ((!owner->stopped_) && (waitSuccess));
-                }
-                return true;
-            }
+        std::atomic<bool>                                               stopped_{false};
 
-        } waitableState_;
+        // debug builds only.  the number of work_contracts which refer to this group
+        std::atomic<std::int64_t>                                       handleCount_{0};
 
-    }; // class work_contract_group
+        static thread_local std::uint64_t                               tls_biasFlags_;
 
+        static thread_local std::uint64_t                               tls_bandTick_;
 
-    //=========================================================================
-    template <synchronization_mode T>
-    class work_contract_group<T>::release_token final :
-        non_copyable,
-        non_movable
-    {
-    public:
-        release_token() = delete;
-        release_token(work_contract_group *);
-        bool schedule(work_contract_type const &);
-        void orphan();
-        bool is_valid() const;
-        std::mutex mutable      mutex_;
-        work_contract_group *    workContractGroup_{};
-    }; // class work_contract_group<>::release_token
+        work_contract_type create_contract_impl
+        (
+            priority_band,
+            auto &&,
+            auto &&,
+            auto &&,
+            work_contract_type::initial_state
+        );
 
+        std::uint64_t select_contract
+        (
+            band &,
+            std::uint64_t,
+            std::uint64_t &
+        );
 
-    //=============================================================================
-    template <bcpp::synchronization_mode T>
-    class bcpp::implementation::work_contract_group<T>::auto_clear_execute_flag
-    {
-    public:
-        auto_clear_execute_flag(std::uint64_t contractId, work_contract_group<T> & owner):contractId_(contractId),owner_(owner){}
-        ~auto_clear_execute_flag(){owner_.clear_execute_flag(contractId_);}
-    private:
-        std::uint64_t               contractId_;
-        work_contract_group<T> &    owner_;
-    };
+        std::uint64_t select_contracts
+        (
+            band &,
+            std::uint64_t,
+            std::uint64_t &,
+            std::uint64_t
+        );
 
+        std::uint64_t execute_contracts
+        (
+            std::uint64_t &,
+            std::uint64_t
+        );
 
-    template <synchronization_mode T>
-    std::uint64_t thread_local work_contract_group<T>::tls_biasFlags_ = 0;
+        std::uint64_t steal_lane_contract
+        (
+            std::uint64_t &
+        );
 
-} // namespace bcpp::implementation
+        void subtree_filled
+        (
+            band &,
+            std::uint64_t
+        ) noexcept;
+
+        void subtree_emptied
+        (
+            band &,
+            std::uint64_t
+        ) noexcept;
+
+        void subtree_remains_filled
+        (
+            std::uint64_t
+        ) noexcept;
 
+        static std::int64_t now_ns() noexcept;
 
-namespace bcpp
+        // execute_for checks the clock once per this many contracts
+        static auto constexpr execute_for_batch_size = 64;
+
+        std::atomic<std::int64_t>                                       nonZeroCounter_{0};
+
+        void decrement_non_zero_counter();
+        void increment_non_zero_counter();
+
+        // park (in blocking mode) until a contract is scheduled.  returns false if 
+        // the group is stopped (or, for the timed version, if the duration elapsed)
+        bool wait_for_contracts();
+
+        bool wait_for_contracts
+        (
+            std::chrono::nanoseconds
+        );
+
+        waitable_state                                                  waitableState_;
+
+        timer_service * get_timer_service();
+
+        // created (along with its tick thread) by the first timed schedule
+        std::unique_ptr<timer_service>                                  timerServiceOwner_;
+
+        std::atomic<timer_service *>                                    timerService_{nullptr};
+
+        void stamp_schedule_time
+        (
+            work_contract_id
+        ) noexcept;
+
+        void record_schedule_latency
+        (
+            std::uint64_t
+        );
+
+        void increment_statistic
+        (
+            statistics_counter,
+            std::uint64_t = 1
+        ) noexcept;
+
+        // statistics only.  counts signal tree select retries (contention) for count_select
+        struct select_retry_counter
+        {
+            void operator()() const noexcept{if constexpr (statistics_enabled) ++retries_;}
+            std::uint64_t & retries_;
+        };
+
+        std::uint64_t count_select
+        (
+            std::uint64_t,
+            std::uint64_t,
+            std::uint64_t
+        ) noexcept;
+
+        std::uint64_t count_poll
+        (
+            std::uint64_t
+        ) noexcept;
+
+        void trace
+        (
+            trace_event_type,
+            work_contract_id
+        ) noexcept;
+
+        // latency instrumentation, statistics and tracing only.  the state of one thread
+        // which has used this group.  written only by that thread.
+        struct thread_state
+        {
+            struct disabled{};
+
+            [[no_unique_address]] std::conditional_t<latency_instrumentation_enabled, latency_histogram, disabled> latency_;
+            [[no_unique_address]] std::conditional_t<statistics_enabled, statistics_counters, disabled> statistics_;
+            [[no_unique_address]] std::conditional_t<tracing_enabled, trace_buffer, disabled> trace_;
+        };
+
+        // a thread's cached pointer to its state for the group which holds a cache slot.
+        // the entry belongs to the group only if owner_ is the group's instanceId_.
+        struct thread_state_cache_entry
+        {
+            std::uint64_t   owner_{0};
+            thread_state *  threadState_{nullptr};
+        };
+
+        // cache slots of live groups.  a destroyed group's slot is reused by a later group.
+        struct thread_state_slots
+        {
+            std::mutex                  mutex_;
+            std::vector<std::uint64_t>  free_;
+            std::uint64_t               next_{0};
+        };
+
+        thread_state & get_thread_state();
+
+        thread_state & register_thread_state();
+
+        static std::uint64_t next_instance_id() noexcept;
+
+        static thread_state_slots & get_thread_state_slots() noexcept;
+
+        static std::uint64_t acquire_thread_state_slot();
+
+        static void release_thread_state_slot
+        (
+            std::uint64_t
+        ) noexcept;
+
+        // threads cache their state (keyed by instanceId_ rather than the group's address
+        // which could be reused by a later group)
+        std::uint64_t const                                             instanceId_{next_instance_id()};
+
+        // the index of this group's entry in each thread's cache (tls_threadStates_)
+        std::uint64_t const                                             threadStateSlot_{acquire_thread_state_slot()};
+
+        std::mutex mutable                                              threadStateMutex_;
+
+        std::vector<std::pair<std::thread::id, std::unique_ptr<thread_state>>> threadStates_;
+
+        static thread_local std::vector<thread_state_cache_entry>       tls_threadStates_;
+
+    }; // class work_contract_group
+
+
+    //=============================================================================
+    template <bcpp::synchronization_mode T>
+    class bcpp::implementation::work_contract_group<T>::auto_clear_execute_flag
+    {
+    public:
+        auto_clear_execute_flag(std::uint64_t contractId, work_contract_group<T> & owner):contractId_(contractId),owner_(owner){}
+        ~auto_clear_execute_flag(){owner_.clear_execute_flag(contractId_);}
+    private:
+        std::uint64_t               contractId_;
+        work_contract_group<T> &    owner_;
+    };
+
+
+    template <synchronization_mode T>
+    std::uint64_t thread_local work_contract_group<T>::tls_biasFlags_ = 0;
+
+    template <synchronization_mode T>
+    std::uint64_t thread_local work_contract_group<T>::tls_bandTick_ = 0;
+
+    template <synchronization_mode T>
+    thread_local std::vector<typename work_contract_group<T>::thread_state_cache_entry> work_contract_group<T>::tls_threadStates_;
+
+} // namespace bcpp::implementation
+
+
+namespace bcpp
+{
+    //=========================================================================
+    using blocking_work_contract_group = implementation::work_contract_group<synchronization_mode::blocking>;
+    using work_contract_group = implementation::work_contract_group<synchronization_mode::non_blocking>;
+
+} // namespace bcpp
+
+
+#include "./work_contract.h"
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline auto bcpp::implementation::work_contract_group<T>::create_contract
+(
+    std::invocable auto && workFunction,
+    work_contract_type::initial_state initialState
+) -> work_contract_type
+{
+    return create_contract(priority_band::highest, std::forward<std::decay_t<decltype(workFunction)>>(workFunction), initialState);
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline auto bcpp::implementation::work_contract_group<T>::create_contract
+(
+    std::invocable auto && workFunction,
+    std::invocable auto && releaseFunction,
+    work_contract_type::initial_state initialState
+) -> work_contract_type
+{    
+    return create_contract(priority_band::highest, std::forward<std::decay_t<decltype(workFunction)>>(workFunction), 
+            std::forward<decltype(releaseFunction)>(releaseFunction), initialState);
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline auto bcpp::implementation::work_contract_group<T>::create_contract
+(
+    std::invocable auto && workFunction,
+    std::invocable auto && releaseFunction,
+    std::invocable<std::exception_ptr> auto && exceptionFunction,
+    work_contract_type::initial_state initialState
+) -> work_contract_type
+{    
+    return create_contract(priority_band::highest, std::forward<std::decay_t<decltype(workFunction)>>(workFunction), 
+            std::forward<decltype(releaseFunction)>(releaseFunction), std::forward<decltype(exceptionFunction)>(exceptionFunction), initialState);
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline auto bcpp::implementation::work_contract_group<T>::create_contract
+(
+    priority_band priorityBand,
+    std::invocable auto && workFunction,
+    work_contract_type::initial_state initialState
+) -> work_contract_type
+{
+    return create_contract_impl(priorityBand, std::forward<std::decay_t<decltype(workFunction)>>(workFunction), 
+            no_callback{}, no_callback{}, initialState);
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline auto bcpp::implementation::work_contract_group<T>::create_contract
+(
+    priority_band priorityBand,
+    std::invocable auto && workFunction,
+    std::invocable auto && releaseFunction,
+    work_contract_type::initial_state initialState
+) -> work_contract_type
+{    
+    return create_contract_impl(priorityBand, std::forward<std::decay_t<decltype(workFunction)>>(workFunction), 
+            std::forward<decltype(releaseFunction)>(releaseFunction), no_callback{}, initialState);
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline auto bcpp::implementation::work_contract_group<T>::create_contract
+(
+    priority_band priorityBand,
+    std::invocable auto && workFunction,
+    std::invocable auto && releaseFunction,
+    std::invocable<std::exception_ptr> auto && exceptionFunction,
+    work_contract_type::initial_state initialState
+) -> work_contract_type
+{
+    return create_contract_impl(priorityBand, std::forward<std::decay_t<decltype(workFunction)>>(workFunction), 
+            std::forward<decltype(releaseFunction)>(releaseFunction), std::forward<decltype(exceptionFunction)>(exceptionFunction), initialState);
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline auto bcpp::implementation::work_contract_group<T>::create_contract
+(
+    // the contract is only selected by workers executing the specified lane
+    // (or, if stealing is configured, by any worker once the lane falls behind)
+    execution_lane executionLane,
+    std::invocable auto && workFunction,
+    work_contract_type::initial_state initialState
+) -> work_contract_type
+{
+    return create_contract(priority_band{bandCount_ + static_cast<std::uint64_t>(executionLane)}, 
+            std::forward<std::decay_t<decltype(workFunction)>>(workFunction), initialState);
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline auto bcpp::implementation::work_contract_group<T>::create_contract
+(
+    execution_lane executionLane,
+    std::invocable auto && workFunction,
+    std::invocable auto && releaseFunction,
+    work_contract_type::initial_state initialState
+) -> work_contract_type
+{
+    return create_contract(priority_band{bandCount_ + static_cast<std::uint64_t>(executionLane)}, 
+            std::forward<std::decay_t<decltype(workFunction)>>(workFunction), 
+            std::forward<decltype(releaseFunction)>(releaseFunction), initialState);
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline auto bcpp::implementation::work_contract_group<T>::create_contract
+(
+    execution_lane executionLane,
+    std::invocable auto && workFunction,
+    std::invocable auto && releaseFunction,
+    std::invocable<std::exception_ptr> auto && exceptionFunction,
+    work_contract_type::initial_state initialState
+) -> work_contract_type
+{
+    return create_contract(priority_band{bandCount_ + static_cast<std::uint64_t>(executionLane)}, 
+            std::forward<std::decay_t<decltype(workFunction)>>(workFunction), 
+            std::forward<decltype(releaseFunction)>(releaseFunction), std::forward<decltype(exceptionFunction)>(exceptionFunction), initialState);
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline auto bcpp::implementation::work_contract_group<T>::create_contract
+(
+    max_concurrency maxConcurrency,
+    std::invocable auto && workFunction,
+    work_contract_type::initial_state initialState
+) -> work_contract_type
+{
+    return make_parallel(create_contract(std::forward<std::decay_t<decltype(workFunction)>>(workFunction)), 
+            maxConcurrency, initialState);
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline auto bcpp::implementation::work_contract_group<T>::create_contract
+(
+    max_concurrency maxConcurrency,
+    std::invocable auto && workFunction,
+    std::invocable auto && releaseFunction,
+    work_contract_type::initial_state initialState
+) -> work_contract_type
+{
+    return make_parallel(create_contract(std::forward<std::decay_t<decltype(workFunction)>>(workFunction), 
+            std::forward<decltype(releaseFunction)>(releaseFunction)), maxConcurrency, initialState);
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline auto bcpp::implementation::work_contract_group<T>::create_contract
+(
+    max_concurrency maxConcurrency,
+    std::invocable auto && workFunction,
+    std::invocable auto && releaseFunction,
+    std::invocable<std::exception_ptr> auto && exceptionFunction,
+    work_contract_type::initial_state initialState
+) -> work_contract_type
+{
+    return make_parallel(create_contract(std::forward<std::decay_t<decltype(workFunction)>>(workFunction), 
+            std::forward<decltype(releaseFunction)>(releaseFunction), std::forward<decltype(exceptionFunction)>(exceptionFunction)), 
+            maxConcurrency, initialState);
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline auto bcpp::implementation::work_contract_group<T>::create_contract_impl
+(
+    // release and exception functions which are no_callback are not stored at all.
+    // the cold callback storage for a contract is only allocated if at least one of 
+    // them is provided.
+    priority_band priorityBand,
+    auto && workFunction,
+    auto && releaseFunction,
+    auto && exceptionFunction,
+    work_contract_type::initial_state initialState
+) -> work_contract_type
+{
+    static auto constexpr has_release = (!std::is_same_v<std::decay_t<decltype(releaseFunction)>, no_callback>);
+    static auto constexpr has_exception = (!std::is_same_v<std::decay_t<decltype(exceptionFunction)>, no_callback>);
+
+    if (auto workContractId = get_available_contract(priorityBand); workContractId != ~0ull)
+    {
+        increment_statistic(statistics_counter::contracts_created);
+        auto & segment = get_segment(workContractId);
+        auto index = (workContractId - segment.firstContractId_);
+        auto & contract = segment.contracts_[index];
+        contract.flags_ &= generation_mask;
+        contract.work_ = std::forward<std::decay_t<decltype(workFunction)>>(workFunction);
+
+        if constexpr (has_release || has_exception)
+        {
+            auto & callbacks = (segment.callbacks_[index] = std::make_unique<contract_callbacks>());
+            if constexpr (has_release)
+                callbacks->release_ = std::forward<decltype(releaseFunction)>(releaseFunction); 
+            if constexpr (has_exception)
+                callbacks->exception_ = std::forward<decltype(exceptionFunction)>(exceptionFunction);
+        }
+        return {this, (workContractId | (contract.flags_.load() & generation_mask)), initialState};
+    }
+    return {};
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline void bcpp::implementation::work_contract_group<T>::increment_non_zero_counter
+(
+)
+{
+    // each subtree which becomes non empty wakes (at most) one parked worker
+    ++nonZeroCounter_;
+    waitableState_.notify_one();
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline void bcpp::implementation::work_contract_group<T>::decrement_non_zero_counter
+(
+)
+{
+    --nonZeroCounter_;
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline void bcpp::implementation::work_contract_group<T>::subtree_filled
+(
+    // a subtree of the specified band has become non empty.  with more than one band, 
+    // track non empty subtrees per band so that workers can skip empty bands with a 
+    // single load.  lanes wake (and start the steal clock for) their own workers only.
+    band & band,
+    std::uint64_t bandIndex
+) noexcept
+{
+    if (trackNonEmptySubTrees_)
+    {
+        auto bandWasEmpty = (band.nonEmptySubTreeCount_++ == 0);
+        if (bandIndex >= bandCount_)
+        {
+            auto & lane = lanes_[bandIndex - bandCount_];
+            if ((bandWasEmpty) && (stealAfter_ > 0))
+                lane.lastSelectTime_.store(now_ns(), std::memory_order_relaxed);
+            if constexpr (mode == synchronization_mode::blocking)
+                lane.waitableState_.notify_one();
+            return;
+        }
+    }
+    if constexpr (mode == synchronization_mode::blocking)
+        increment_non_zero_counter();
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline void bcpp::implementation::work_contract_group<T>::subtree_emptied
+(
+    band & band,
+    std::uint64_t bandIndex
+) noexcept
+{
+    if (trackNonEmptySubTrees_)
+        --band.nonEmptySubTreeCount_;
+    if constexpr (mode == synchronization_mode::blocking)
+    {
+        if (bandIndex < bandCount_)
+            decrement_non_zero_counter();
+    }
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline void bcpp::implementation::work_contract_group<T>::subtree_remains_filled
+(
+    // blocking mode only.  a contract was selected from a subtree which still holds
+    // scheduled contracts.  only a subtree becoming non empty wakes a parked worker
+    // so wake (at most) one more for the contracts which remain.  when no worker is
+    // parked this is a single load.
+    std::uint64_t bandIndex
+) noexcept
+{
+    if constexpr (mode == synchronization_mode::blocking)
+    {
+        if (bandIndex < bandCount_)
+            waitableState_.notify_one();
+        else
+            lanes_[bandIndex - bandCount_].waitableState_.notify_one();
+    }
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline std::int64_t bcpp::implementation::work_contract_group<T>::now_ns
+(
+) noexcept
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline bool bcpp::implementation::work_contract_group<T>::wait_for_contracts
+(
+)
+{
+    waitableState_.wait([this](){return ((nonZeroCounter_ != 0) || (stopped_));});
+    return (not stopped_);
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline bool bcpp::implementation::work_contract_group<T>::wait_for_contracts
+(
+    std::chrono::nanoseconds duration
+)
+{
+    auto isReady = waitableState_.wait_for([this](){return ((nonZeroCounter_ != 0) || (stopped_));}, duration);
+    return ((isReady) && (not stopped_));
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline auto bcpp::implementation::work_contract_group<T>::get_tree_and_signal_index
+(
+    // returns the index of the subtree (within the contract's band) and the signal
+    // index (within that subtree) of the specified contract
+    work_contract_id workContractId
+) const -> std::tuple<std::uint64_t, std::uint64_t> 
+{
+    workContractId &= contract_index_mask;
+    return {workContractId / signal_tree_capacity, workContractId % signal_tree_capacity};
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline auto bcpp::implementation::work_contract_group<T>::get_band
+(
+    work_contract_id contractId
+) const noexcept -> band &
+{
+    return bands_[(contractId & ~generation_mask) >> band_shift];
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline auto bcpp::implementation::work_contract_group<T>::get_segment
+(
+    // return the segment which contains the specified subtree.  segment zero holds
+    // the initial subtrees and segment n holds subtrees [initial << (n - 1), initial << n)
+    band const & band,
+    std::uint64_t subTreeIndex
+) const noexcept -> segment &
+{
+    return *band.segments_[std::bit_width(subTreeIndex >> initialSubTreeShift_)];
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline auto bcpp::implementation::work_contract_group<T>::get_segment
+(
+    work_contract_id contractId
+) const noexcept -> segment &
+{
+    return get_segment(get_band(contractId), (contractId & contract_index_mask) / signal_tree_capacity);
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline auto bcpp::implementation::work_contract_group<T>::get_contract
+(
+    work_contract_id contractId
+) const noexcept -> contract &
+{
+    auto & segment = get_segment(contractId);
+    return segment.contracts_[(contractId & ~generation_mask) - segment.firstContractId_];
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline std::uint64_t bcpp::implementation::work_contract_group<T>::capacity
+(
+) const
+{
+    auto subTreeCount = 0ull;
+    for (auto i = 0ull; i < (bandCount_ + laneCount_); ++i)
+        subTreeCount += bands_[i].subTreeCount_.load(std::memory_order_acquire);
+    return (subTreeCount * signal_tree_capacity);
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline std::uint64_t bcpp::implementation::work_contract_group<T>::band_count
+(
+) const
+{
+    return bandCount_;
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline std::uint64_t bcpp::implementation::work_contract_group<T>::lane_count
+(
+) const
+{
+    return laneCount_;
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline void bcpp::implementation::work_contract_group<T>::set_spin_window
+(
+    // workers which find no scheduled contracts spin for up to spinWindow before 
+    // parking.  with adaptive spinning each worker thread tunes its own spin limit 
+    // (up to spinWindow) based on whether spinning recently found work.
+    std::chrono::nanoseconds spinWindow,
+    bool adaptive
+) requires (mode == synchronization_mode::blocking)
+{
+    waitableState_.set_spin_window(spinWindow, adaptive);
+    for (auto i = 0ull; i < laneCount_; ++i)
+        lanes_[i].waitableState_.set_spin_window(spinWindow, adaptive);
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline std::chrono::nanoseconds bcpp::implementation::work_contract_group<T>::get_spin_window
+(
+) const requires (mode == synchronization_mode::blocking)
+{
+    return waitableState_.get_spin_window();
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline void bcpp::implementation::work_contract_group<T>::release_unchecked
+(
+    // release the currently executing contract (this_contract).  no generation check
+    // is required as a contract can not be erased while it is executing.
+    work_contract_id contractId
+) noexcept
+{
+    static auto constexpr flags_to_set = (contract::release_flag | contract::schedule_flag);
+    auto previousFlags = get_contract(contractId).flags_.fetch_or(flags_to_set);
+    auto notScheduledNorExecuting = ((previousFlags & (contract::schedule_flag | contract::execute_flag)) == 0);
+    if (notScheduledNorExecuting)
+        set_contract_signal(contractId);
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline void bcpp::implementation::work_contract_group<T>::schedule_unchecked
+(
+    // schedule the currently executing contract (this_contract).
+    // set the schedule flag.  if not previously set, and not currently executing
+    // then also set the signal associated with the contract.
+    work_contract_id contractId
+) noexcept
+{
+    static auto constexpr flags_to_set = contract::schedule_flag;
+    increment_statistic(statistics_counter::schedule_calls);
+    trace(trace_event_type::schedule, contractId);
+    stamp_schedule_time(contractId);
+    auto previousFlags = get_contract(contractId).flags_.fetch_or(flags_to_set);
+    auto notScheduledNorExecuting = ((previousFlags & (contract::schedule_flag | contract::execute_flag)) == 0);
+    if (notScheduledNorExecuting)
+        set_contract_signal(contractId);
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline auto bcpp::implementation::work_contract_group<T>::set_flags_if_valid
+(
+    // set the specified flags on the contract only if the generation of the contract's 
+    // slot matches the generation within the contract id.  returns the previous flags
+    // or invalid_flags if the id is stale.  if the flags are already set no write is done.
+    work_contract_id contractId,
+    state_flags flagsToSet
+) noexcept -> state_flags
+{
+    auto & contract = get_contract(contractId);
+    auto expected = contract.flags_.load();
+    while (((expected ^ contractId) & generation_mask) == 0)
+    {
+        if ((expected & flagsToSet) == flagsToSet)
+            return expected;
+        if (contract.flags_.compare_exchange_weak(expected, expected | flagsToSet))
+            return expected;
+    }
+    return invalid_flags;
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline bool bcpp::implementation::work_contract_group<T>::schedule
+(
+    // schedule the contract with the specified id.  returns false (and does nothing)
+    // if the id is stale.  the id can be copied freely (see work_contract::get_id).
+    work_contract_id contractId
+) noexcept
+{
+    increment_statistic(statistics_counter::schedule_calls);
+    trace(trace_event_type::schedule, contractId);
+    stamp_schedule_time(contractId);
+    auto previousFlags = set_flags_if_valid(contractId, contract::schedule_flag);
+    if (previousFlags == invalid_flags)
+        return false;
+    auto notScheduledNorExecuting = ((previousFlags & (contract::schedule_flag | contract::execute_flag)) == 0);
+    if (notScheduledNorExecuting)
+        set_contract_signal(contractId);
+    return true;
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline bool bcpp::implementation::work_contract_group<T>::release
+(
+    // release the contract with the specified id.  returns false (and does nothing)
+    // if the id is stale (the contract has already been erased or the group stopped).
+    work_contract_id contractId
+) noexcept
+{
+    auto previousFlags = set_flags_if_valid(contractId, contract::release_flag | contract::schedule_flag);
+    if (previousFlags == invalid_flags)
+        return false;
+    auto notScheduledNorExecuting = ((previousFlags & (contract::schedule_flag | contract::execute_flag)) == 0);
+    if (notScheduledNorExecuting)
+        set_contract_signal(contractId);
+    return true;
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline bool bcpp::implementation::work_contract_group<T>::is_valid
+(
+    work_contract_id contractId
+) const noexcept
+{
+    return (((get_contract(contractId).flags_.load() ^ contractId) & generation_mask) == 0);
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline void bcpp::implementation::work_contract_group<T>::set_contract_signal
+(
+    // set the signal that is associated with the specified contract
+    work_contract_id contractId
+) noexcept
+{
+    auto & band = get_band(contractId);
+    auto [treeIndex, signalIndex] = get_tree_and_signal_index(contractId);
+    auto & segment = get_segment(band, treeIndex);
+    auto [treeWasEmpty, success] = segment.signalTree_[treeIndex - segment.firstSubTreeIndex_].set(signalIndex);
+    if (treeWasEmpty)
+        subtree_filled(band, (contractId & ~generation_mask) >> band_shift);
+    increment_statistic(statistics_counter::signals_set, success);
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline void bcpp::implementation::work_contract_group<T>::set_contract_signals
+(
+    // set several signals which share one leaf node of a signal tree with a single
+    // update per tree node.  firstContractId is the id of the first contract of the leaf 
+    // and bit (0x8000000000000000 >> n) of bits is the signal for contract (firstContractId + n).
+    work_contract_id firstContractId,
+    std::uint64_t bits
+) noexcept
+{
+    auto & band = get_band(firstContractId);
+    auto [treeIndex, signalIndex] = get_tree_and_signal_index(firstContractId);
+    auto & segment = get_segment(band, treeIndex);
+    auto [treeWasEmpty, signalsSet] = segment.signalTree_[treeIndex - segment.firstSubTreeIndex_].set_bits(signalIndex, bits);
+    if (treeWasEmpty)
+        subtree_filled(band, (firstContractId & ~generation_mask) >> band_shift);
+    increment_statistic(statistics_counter::signals_set, signalsSet);
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline void bcpp::implementation::work_contract_group<T>::schedule
+(
+    // schedule many contracts at once.  each contract's schedule flag is still set 
+    // individually but the signals of contracts which share a signal tree leaf node 
+    // are published together (one fetch_or on the leaf, one fetch_add per parent).
+    // contracts which do not belong to this group (or are no longer valid) are ignored.
+    std::span<work_contract_type> workContracts
+) noexcept
 {
-    //=========================================================================
-    using blocking_work_contract_group = implementation::work_contract_group<synchronization_mode::blocking>;
-    using work_contract_group = implementation::work_contract_group<synchronization_mode::non_blocking>;
+    static auto constexpr leaf_capacity = 64ull;
+    static auto constexpr pending_leaf_count = 8ull;
 
-} // namespace bcpp
+    // pending leaf bits are coalesced in a small direct mapped table.  fan out from
+    // contracts created together is mostly runs of neighbouring ids and so coalesces
+    // well without needing to sort the ids.
+    struct pending_leaf
+    {
+        work_contract_id    firstContractId_{~0ull};
+        std::uint64_t       bits_{0};
+    };
+    std::array<pending_leaf, pending_leaf_count> pendingLeaves;
 
+    for (auto & workContract : workContracts)
+    {
+        if (workContract.owner_.load(std::memory_order_relaxed) != this)
+            continue;
+        auto contractId = workContract.id_;
+        increment_statistic(statistics_counter::schedule_calls);
+        trace(trace_event_type::schedule, contractId);
+        stamp_schedule_time(contractId);
+        auto previousFlags = set_flags_if_valid(contractId, contract::schedule_flag);
+        if ((previousFlags == invalid_flags) || ((previousFlags & (contract::schedule_flag | contract::execute_flag)) != 0))
+            continue;
+        contractId &= ~generation_mask;
+        auto firstContractId = (contractId & ~(leaf_capacity - 1));
+        auto & pendingLeaf = pendingLeaves[(firstContractId / leaf_capacity) % pending_leaf_count];
+        if (pendingLeaf.firstContractId_ != firstContractId)
+        {
+            if (pendingLeaf.bits_)
+                set_contract_signals(pendingLeaf.firstContractId_, pendingLeaf.bits_);
+            pendingLeaf = {firstContractId, 0};
+        }
+        pendingLeaf.bits_ |= (0x8000000000000000ull >> (contractId % leaf_capacity));
+    }
 
-#include "./work_contract.h"
+    for (auto & pendingLeaf : pendingLeaves)
+        if (pendingLeaf.bits_)
+            set_contract_signals(pendingLeaf.firstContractId_, pendingLeaf.bits_);
+}
 
 
 //=============================================================================
 template <bcpp::synchronization_mode T>
-inline auto bcpp::implementation::work_contract_group<T>::create_contract
+inline std::uint64_t bcpp::implementation::work_contract_group<T>::execute_next_contract
 (
-    std::invocable auto && workFunction,
-    work_contract_type::initial_state initialState
-) -> work_contract_type
+    // select a signal (a set signal) from the array of signal trees and, if found,
+    // (which clears the signal) then process the pending action on that contract
+    // based on the flags associated with that contract.
+)
 {
-    return create_contract(std::forward<std::decay_t<decltype(workFunction)>>(workFunction), [](){}, initialState);
+    return execute_next_contract(tls_biasFlags_);
 }
 
 
 //=============================================================================
 template <bcpp::synchronization_mode T>
-inline auto bcpp::implementation::work_contract_group<T>::create_contract
+inline std::uint64_t bcpp::implementation::work_contract_group<T>::execute_next_contract
 (
-    std::invocable auto && workFunction,
-    std::invocable auto && releaseFunction,
-    work_contract_type::initial_state initialState
-) -> work_contract_type
-{    
-    return create_contract(std::forward<std::decay_t<decltype(workFunction)>>(workFunction), 
-            std::forward<decltype(releaseFunction)>(releaseFunction), [](auto){}, initialState);
+    // select a signal (a set signal) from the array of signal trees and, if found,
+    // (which clears the signal) then process the pending action on that contract
+    // based on the flags associated with that contract.
+    // with multiple bands, higher priority bands are selected from first.  in weighted
+    // mode the first band to try is taken from the band schedule instead.
+    std::uint64_t & biasFlags
+) 
+{
+    if constexpr (mode == synchronization_mode::blocking)
+    {
+        if (!wait_for_contracts())
+            return ~0ull;
+    }        
+
+    if (bandCount_ == 1)
+    {
+        if (auto signalIndex = select_contract(bands_[0], 0, biasFlags); ((signalIndex != ~0ull) || (stealAfter_ == 0)))
+            return count_poll(signalIndex);
+        return count_poll(steal_lane_contract(biasFlags));
+    }
+
+    auto firstBandIndex = bandSchedule_.empty() ? 0ull : bandSchedule_[tls_bandTick_++ % bandSchedule_.size()];
+    if (bands_[firstBandIndex].nonEmptySubTreeCount_.load(std::memory_order_relaxed) > 0)
+        if (auto signalIndex = select_contract(bands_[firstBandIndex], firstBandIndex, biasFlags); signalIndex != ~0ull)
+            return signalIndex;
+    for (auto bandIndex = 0ull; bandIndex < bandCount_; ++bandIndex)
+    {
+        if ((bandIndex != firstBandIndex) && (bands_[bandIndex].nonEmptySubTreeCount_.load(std::memory_order_relaxed) > 0))
+            if (auto signalIndex = select_contract(bands_[bandIndex], bandIndex, biasFlags); signalIndex != ~0ull)
+                return signalIndex;
+    }
+    return count_poll((stealAfter_ > 0) ? steal_lane_contract(biasFlags) : ~0ull);
 }
 
 
 //=============================================================================
 template <bcpp::synchronization_mode T>
-inline auto bcpp::implementation::work_contract_group<T>::create_contract
+inline std::uint64_t bcpp::implementation::work_contract_group<T>::execute_next_contract
 (
-    std::invocable auto && workFunction,
-    std::invocable auto && releaseFunction,
-    std::invocable<std::exception_ptr> auto && exceptionFunction,
-    work_contract_type::initial_state initialState
-) -> work_contract_type
+    // select and execute the next scheduled contract from the specified band only
+    priority_band priorityBand,
+    std::uint64_t & biasFlags
+) 
 {
-    if (auto workContractId = get_available_contract(); workContractId != ~0ull)
+    if constexpr (mode == synchronization_mode::blocking)
     {
-        auto & contract = contracts_[workContractId];
-        contract.flags_ = 0;
-        contract.work_ = std::forward<std::decay_t<decltype(workFunction)>>(workFunction);
-
-        release_[workContractId] = std::forward<decltype(releaseFunction)>(releaseFunction); 
-        exception_[workContractId] = std::forward<decltype(exceptionFunction)>(exceptionFunction);
-        return {this, releaseToken_[workContractId] = std::make_shared<release_token>(this), workContractId, initialState};
-    }
-    return {};
+        if (!wait_for_contracts())
+            return ~0ull;
+    }        
+    auto bandIndex = static_cast<std::uint64_t>(priorityBand);
+    return count_poll(select_contract(bands_[bandIndex], bandIndex, biasFlags));
 }
 
 
 //=============================================================================
 template <bcpp::synchronization_mode T>
-inline void bcpp::implementation::work_contract_group<T>::increment_non_zero_counter
+inline std::uint64_t bcpp::implementation::work_contract_group<T>::execute_next_contract
 (
+    execution_lane executionLane
 )
 {
-    if (nonZeroCounter_++ == 0)
-        waitableState_.notify_all();
+    return execute_next_contract(executionLane, tls_biasFlags_);
 }
 
 
 //=============================================================================
 template <bcpp::synchronization_mode T>
-inline void bcpp::implementation::work_contract_group<T>::decrement_non_zero_counter
+inline std::uint64_t bcpp::implementation::work_contract_group<T>::execute_next_contract
 (
+    // select and execute the next scheduled contract of the specified lane.  in
+    // blocking mode, waits (on the lane) until a contract of the lane is scheduled.
+    execution_lane executionLane,
+    std::uint64_t & biasFlags
 )
 {
-    --nonZeroCounter_;
+    auto laneIndex = static_cast<std::uint64_t>(executionLane);
+    auto bandIndex = (bandCount_ + laneIndex);
+    auto & band = bands_[bandIndex];
+    auto & lane = lanes_[laneIndex];
+    if constexpr (mode == synchronization_mode::blocking)
+    {
+        lane.waitableState_.wait([&](){return ((band.nonEmptySubTreeCount_ != 0) || (stopped_));});
+        if (stopped_)
+            return ~0ull;
+    }
+    if (stealAfter_ > 0)
+        lane.lastSelectTime_.store(now_ns(), std::memory_order_relaxed);
+    return count_poll(select_contract(band, bandIndex, biasFlags));
 }
 
 
 //=============================================================================
 template <bcpp::synchronization_mode T>
-inline auto bcpp::implementation::work_contract_group<T>::get_tree_and_signal_index
+inline std::uint64_t bcpp::implementation::work_contract_group<T>::execute_next_contracts
 (
-    work_contract_id workContractId
-) const -> std::tuple<std::uint64_t, std::uint64_t> 
+    // execute up to maxCount scheduled contracts.  returns the number of contracts executed.
+    std::uint64_t maxCount
+)
 {
-    return {workContractId / signal_tree_capacity, workContractId % signal_tree_capacity};
+    return execute_next_contracts(maxCount, tls_biasFlags_);
 }
 
 
 //=============================================================================
 template <bcpp::synchronization_mode T>
-inline void bcpp::implementation::work_contract_group<T>::release
+inline std::uint64_t bcpp::implementation::work_contract_group<T>::execute_next_contracts
 (
-    work_contract_id contractId
-) noexcept
+    // execute up to maxCount scheduled contracts.  returns the number of contracts executed.
+    // in blocking mode this waits (once) for at least one contract to be scheduled.
+    std::uint64_t maxCount,
+    std::uint64_t & biasFlags
+)
 {
-    static auto constexpr flags_to_set = (contract::release_flag | contract::schedule_flag);
-    auto previousFlags = contracts_[contractId].flags_.fetch_or(flags_to_set);
-    auto notScheduledNorExecuting = ((previousFlags & (contract::schedule_flag | contract::execute_flag)) == 0);
-    if (notScheduledNorExecuting)
-        set_contract_signal(contractId);
+    if constexpr (mode == synchronization_mode::blocking)
+    {
+        if (!wait_for_contracts())
+            return 0;
+    }        
+    return execute_contracts(biasFlags, maxCount);
 }
 
 
 //=============================================================================
 template <bcpp::synchronization_mode T>
-inline void bcpp::implementation::work_contract_group<T>::schedule
+template <typename rep, typename period>
+inline std::uint64_t bcpp::implementation::work_contract_group<T>::execute_for
 (
-    // set the schedule flag.  if not previously set, and not currently executing
-    // then also set the signal associated with the contract.
-    work_contract_id contractId
-) noexcept
+    // execute scheduled contracts until the duration has elapsed (or the group is stopped).
+    // returns the number of contracts executed.  in blocking mode, waits while no 
+    // contracts are scheduled but never beyond the end of the duration.
+    std::chrono::duration<rep, period> duration
+)
 {
-    static auto constexpr flags_to_set = contract::schedule_flag;
-    auto previousFlags = contracts_[contractId].flags_.fetch_or(flags_to_set);
-    auto notScheduledNorExecuting = ((previousFlags & (contract::schedule_flag | contract::execute_flag)) == 0);
-    if (notScheduledNorExecuting)
-        set_contract_signal(contractId);
+    auto deadline = std::chrono::steady_clock::now() + duration;
+    auto biasFlags = tls_biasFlags_;
+    auto count = 0ull;
+    for (auto now = std::chrono::steady_clock::now(); ((now < deadline) && (!stopped_)); now = std::chrono::steady_clock::now())
+    {
+        if constexpr (mode == synchronization_mode::blocking)
+        {
+            if (!wait_for_contracts(deadline - now))
+                break;
+        }
+        count += execute_contracts(biasFlags, execute_for_batch_size);
+    }
+    tls_biasFlags_ = biasFlags;
+    return count;
 }
 
 
 //=============================================================================
 template <bcpp::synchronization_mode T>
-inline void bcpp::implementation::work_contract_group<T>::set_contract_signal
+inline std::uint64_t bcpp::implementation::work_contract_group<T>::execute_contracts
 (
-    // set the signal that is associated with the specified contract
-    work_contract_id contractId
-) noexcept
+    // execute up to maxCount contracts without waiting.  single band groups drain
+    // several signals per pass over the subtrees.  with multiple bands the band 
+    // selection is repeated for each contract so that priority is respected.
+    std::uint64_t & biasFlags,
+    std::uint64_t maxCount
+)
 {
-    if constexpr (mode == synchronization_mode::non_blocking)
+    if (bandCount_ == 1)
     {
-        auto [treeIndex, signalIndex] = get_tree_and_signal_index(contractId);
-        signalTree_[treeIndex].set(signalIndex);
+        if (auto count = select_contracts(bands_[0], 0, biasFlags, maxCount); ((count > 0) || (stealAfter_ == 0)))
+        {
+            if (count == 0)
+                count_poll(~0ull);
+            return count;
+        }
+        return (count_poll(steal_lane_contract(biasFlags)) != ~0ull);
     }
-    else
+
+    auto count = 0ull;
+    while (count < maxCount)
     {
-        auto [treeIndex, signalIndex] = get_tree_and_signal_index(contractId);
-        if (auto [treeWasEmpty, success] = signalTree_[treeIndex].set(signalIndex); treeWasEmpty)
+        auto firstBandIndex = bandSchedule_.empty() ? 0ull : bandSchedule_[tls_bandTick_++ % bandSchedule_.size()];
+        auto executed = ((bands_[firstBandIndex].nonEmptySubTreeCount_.load(std::memory_order_relaxed) > 0) && 
+                (select_contract(bands_[firstBandIndex], firstBandIndex, biasFlags) != ~0ull));
+        for (auto bandIndex = 0ull; ((!executed) && (bandIndex < bandCount_)); ++bandIndex)
         {
-            increment_non_zero_counter();
+            if ((bandIndex != firstBandIndex) && (bands_[bandIndex].nonEmptySubTreeCount_.load(std::memory_order_relaxed) > 0))
+                executed = (select_contract(bands_[bandIndex], bandIndex, biasFlags) != ~0ull);
         }
+        if (!executed)
+            break;
+        ++count;
     }
+    if ((count == 0) && (stealAfter_ > 0))
+        count = (steal_lane_contract(biasFlags) != ~0ull);
+    if (count == 0)
+        count_poll(~0ull);
+    return count;
 }
 
 
 //=============================================================================
 template <bcpp::synchronization_mode T>
-inline std::uint64_t bcpp::implementation::work_contract_group<T>::execute_next_contract
+inline std::uint64_t bcpp::implementation::work_contract_group<T>::steal_lane_contract
 (
-    // select a signal (a set signal) from the array of signal trees and, if found,
-    // (which clears the signal) then process the pending action on that contract
-    // based on the flags associated with that contract.
+    // select a contract from a lane whose own workers have not selected from it
+    // for at least stealAfter_ while it has had scheduled contracts
+    std::uint64_t & biasFlags
 )
 {
-    return execute_next_contract(tls_biasFlags_);
+    std::int64_t now = 0;
+    for (auto laneIndex = 0ull; laneIndex < laneCount_; ++laneIndex)
+    {
+        auto bandIndex = (bandCount_ + laneIndex);
+        if (bands_[bandIndex].nonEmptySubTreeCount_.load(std::memory_order_relaxed) == 0)
+            continue;
+        if (now == 0)
+            now = now_ns();
+        if ((now - lanes_[laneIndex].lastSelectTime_.load(std::memory_order_relaxed)) < stealAfter_)
+            continue;
+        if (auto signalIndex = select_contract(bands_[bandIndex], bandIndex, biasFlags); signalIndex != ~0ull)
+            return signalIndex;
+    }
+    return ~0ull;
 }
 
 
 //=============================================================================
 template <bcpp::synchronization_mode T>
-inline std::uint64_t bcpp::implementation::work_contract_group<T>::execute_next_contract
+inline std::uint64_t bcpp::implementation::work_contract_group<T>::select_contracts
 (
-    // select a signal (a set signal) from the array of signal trees and, if found,
-    // (which clears the signal) then process the pending action on that contract
-    // based on the flags associated with that contract.
-    std::uint64_t & biasFlags
+    // select up to maxCount signals from the subtrees of the specified band and process
+    // the associated contracts.  the bias and current subtree are kept local across 
+    // selections rather than being recomputed per contract.  stops once every subtree
+    // has been found empty in succession.  returns the number of contracts processed.
+    band & band,
+    std::uint64_t bandIndex,
+    std::uint64_t & biasFlagsRef,
+    std::uint64_t maxCount
 ) 
 {
-    if constexpr (mode == synchronization_mode::blocking)
-    {
-        if (!waitableState_.wait(this))// this should be done more graceful but for now ..
-            return ~0ull;
-    }        
-    
+    auto biasFlags = biasFlagsRef;
+    auto count = 0ull;
+    auto subTreeCount = band.subTreeCount_.load(std::memory_order_acquire);
+    auto subTreeMask = (subTreeCount - 1);
     auto subTreeIndex = (biasFlags / signal_tree_type::capacity);
-    for (auto i = 0ull; i < signalTree_.size(); ++i)
+    auto emptyCount = 0ull;
+    std::uint64_t selectRetries = 0;
+    while ((emptyCount < subTreeCount) && (count < maxCount))
     {
-        subTreeIndex &= subTreeMask_;
-        if (auto [signalIndex, treeIsEmpty] = signalTree_[subTreeIndex].select(biasFlags); signalIndex != invalid_signal_index)
+        subTreeIndex &= subTreeMask;
+        auto & segment = get_segment(band, subTreeIndex);
+        if (auto [signalIndex, treeIsEmpty] = segment.signalTree_[subTreeIndex - segment.firstSubTreeIndex_].select(biasFlags, select_retry_counter{selectRetries}); signalIndex != invalid_signal_index)
         {
-            if constexpr (mode == synchronization_mode::blocking)
+            if (treeIsEmpty)
+                subtree_emptied(band, bandIndex);
+            else
+                subtree_remains_filled(bandIndex);
+            work_contract_id workContractId((bandIndex << band_shift) | (subTreeIndex * signal_tree_capacity));
+            workContractId |= signalIndex;
+            auto x = (signal_tree::select_bias_hint ^ biasFlags);
+            auto b = (x & (~x + 1ull)) & (signal_tree_type::capacity - 1);
+            if (b == 0)
+            {
+                biasFlags = ((subTreeIndex + 1) * signal_tree_type::capacity);
+            }
+            else
             {
-                if (treeIsEmpty)
-                    decrement_non_zero_counter();
+                biasFlags |= b;
+                biasFlags &= ~(b - 1);
             }
-            work_contract_id workContractId(subTreeIndex * signal_tree_capacity);
+            process_contract(workContractId);
+            count_select(0, emptyCount + 1, std::exchange(selectRetries, 0));
+            subTreeIndex = (biasFlags / signal_tree_type::capacity);
+            emptyCount = 0;
+            ++count;
+        }
+        else
+        {
+            biasFlags = (++subTreeIndex * signal_tree_type::capacity);
+            ++emptyCount;
+        }
+    }
+    if (emptyCount > 0)
+        count_select(0, emptyCount, selectRetries);
+    biasFlagsRef = biasFlags;
+    return count;
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline std::uint64_t bcpp::implementation::work_contract_group<T>::select_contract
+(
+    // select a signal from the subtrees of the specified band and, if found,
+    // process the contract associated with that signal.
+    band & band,
+    std::uint64_t bandIndex,
+    std::uint64_t & biasFlags
+) 
+{
+    // subtrees added by a concurrent grow are picked up on the next call
+    auto subTreeCount = band.subTreeCount_.load(std::memory_order_acquire);
+    auto subTreeMask = (subTreeCount - 1);
+    auto subTreeIndex = (biasFlags / signal_tree_type::capacity);
+    std::uint64_t selectRetries = 0;
+    for (auto i = 0ull; i < subTreeCount; ++i)
+    {
+        subTreeIndex &= subTreeMask;
+        auto & segment = get_segment(band, subTreeIndex);
+        if (auto [signalIndex, treeIsEmpty] = segment.signalTree_[subTreeIndex - segment.firstSubTreeIndex_].select(biasFlags, select_retry_counter{selectRetries}); signalIndex != invalid_signal_index)
+        {
+            if (treeIsEmpty)
+                subtree_emptied(band, bandIndex);
+            else
+                subtree_remains_filled(bandIndex);
+            work_contract_id workContractId((bandIndex << band_shift) | (subTreeIndex * signal_tree_capacity));
             workContractId |= signalIndex;
             auto x = (signal_tree::select_bias_hint ^ biasFlags);
             auto b = (x & (~x + 1ull)) & (signal_tree_type::capacity - 1);
@@ -506,11 +1798,11 @@ inline std::uint64_t bcpp::implementation::work_contract_group<T>::execute_next_
                 biasFlags &= ~(b - 1);
             }
             process_contract(workContractId);
-            return signalIndex;
+            return count_select(signalIndex, i + 1, selectRetries);
         }
         biasFlags = (++subTreeIndex * signal_tree_type::capacity);
     }
-    return ~0ull;
+    return count_select(~0ull, subTreeCount, selectRetries);
 }
 
 
@@ -521,26 +1813,44 @@ inline void bcpp::implementation::work_contract_group<T>::process_contract
     work_contract_id contractId
 )
 {
-    auto & contract = contracts_[contractId];
+    auto & segment = get_segment(contractId);
+    auto index = (contractId & ~generation_mask) - segment.firstContractId_;
+    auto & contract = segment.contracts_[index];
+    // the schedule time is read before the schedule flag is cleared.  a schedule which 
+    // follows the clearing of the flag stamps the time of the next execution.
+    [[maybe_unused]] std::uint64_t scheduleTime;
+    if constexpr (latency_instrumentation_enabled)
+        scheduleTime = segment.scheduleTimes_[index].load(std::memory_order_relaxed);
     auto flags = ++contract.flags_;
 
-    if (auto isReleased = ((flags & contract::release_flag) == contract::release_flag); isReleased)
+    if ((flags & (contract::release_flag | contract::parallel_flag)) != 0) [[unlikely]]
     {
-        // release should be far less common path so ensure not inlined 
-        process_release(contractId);
+        // release and parallel contracts should be far less common paths so ensure not inlined 
+        if ((flags & contract::parallel_flag) == contract::parallel_flag)
+            process_parallel_contract(contractId, flags);
+        else
+            process_release(contractId);
         return;
     }
+
+    if constexpr (latency_instrumentation_enabled)
+    {
+        auto now = read_tsc();
+        record_schedule_latency((now > scheduleTime) ? (now - scheduleTime) : 0);
+    }
     
     // the expected case. invoke the work function
+    increment_statistic(statistics_counter::executions);
+    trace(trace_event_type::start, contractId);
     auto_clear_execute_flag autoClearExecuteFlag(contractId, *this);
 
     static constexpr void(*release)(work_contract_id, void *) = [](auto contractId, void * group) noexcept
         {
-            reinterpret_cast<work_contract_group<T> *>(group)->release(contractId);
+            reinterpret_cast<work_contract_group<T> *>(group)->release_unchecked(contractId);
         };
     static constexpr void(*schedule)(work_contract_id, void *) = [](auto contractId, void * group) noexcept
         {
-            reinterpret_cast<work_contract_group<T> *>(group)->schedule(contractId);
+            reinterpret_cast<work_contract_group<T> *>(group)->schedule_unchecked(contractId);
         };
     bcpp::this_contract thisContract(contractId, this, release, schedule);
     try
@@ -581,7 +1891,7 @@ inline std::uint64_t bcpp::implementation::work_contract_group<T>::execute_next_
     std::uint64_t & biasFlags
 ) requires (mode == synchronization_mode::blocking)
 {
-    if (waitableState_.wait_for(this, duration))
+    if (wait_for_contracts(duration))
         return this->execute_next_contract(biasFlags);
     return ~0ull;
 }
@@ -594,7 +1904,179 @@ inline void bcpp::implementation::work_contract_group<T>::clear_execute_flag
     work_contract_id contractId
 ) noexcept
 {
-    if (((contracts_[contractId].flags_ -= contract::execute_flag) & contract::schedule_flag) == contract::schedule_flag)
+    trace(trace_event_type::end, contractId);
+    if (((get_contract(contractId).flags_ -= contract::execute_flag) & contract::schedule_flag) == contract::schedule_flag)
         set_contract_signal(contractId);
 }
 
+
+namespace bcpp
+{
+    //=========================================================================
+    // spin then park.  a blocking group whose idle workers spin (adaptively, for up
+    // to default_spin_window) before parking.  bursty workloads see close to non 
+    // blocking latency while idle workers still park rather than consuming a core.
+    // contracts are blocking_work_contracts.
+    class hybrid_work_contract_group final :
+        public blocking_work_contract_group
+    {
+    public:
+
+        static auto constexpr default_spin_window = std::chrono::microseconds(50);
+
+        hybrid_work_contract_group
+        (
+        ):
+            blocking_work_contract_group()
+        {
+            set_spin_window(default_spin_window, true);
+        }
+
+        hybrid_work_contract_group
+        (
+            std::uint64_t capacity
+        ):
+            blocking_work_contract_group(capacity)
+        {
+            set_spin_window(default_spin_window, true);
+        }
+
+        hybrid_work_contract_group
+        (
+            std::uint64_t capacity,
+            std::uint64_t bandCount,
+            lane_configuration laneConfiguration = {}
+        ):
+            blocking_work_contract_group(capacity, bandCount, laneConfiguration)
+        {
+            set_spin_window(default_spin_window, true);
+        }
+
+        hybrid_work_contract_group
+        (
+            std::uint64_t capacity,
+            std::vector<std::uint64_t> const & bandWeights,
+            lane_configuration laneConfiguration = {}
+        ):
+            blocking_work_contract_group(capacity, bandWeights, laneConfiguration)
+        {
+            set_spin_window(default_spin_window, true);
+        }
+    };
+
+} // namespace bcpp
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline void bcpp::implementation::work_contract_group<T>::stamp_schedule_time
+(
+    // latency instrumentation only.  stamp the time at which the contract's schedule
+    // flag is set (if it is not already set).  the stamp precedes the setting of the
+    // flag so a worker which executes the contract always sees it.
+    work_contract_id contractId
+) noexcept
+{
+    if constexpr (latency_instrumentation_enabled)
+    {
+        auto & segment = get_segment(contractId);
+        auto index = (contractId & ~generation_mask) - segment.firstContractId_;
+        if ((segment.contracts_[index].flags_.load(std::memory_order_relaxed) & contract::schedule_flag) == 0)
+            segment.scheduleTimes_[index].store(read_tsc(), std::memory_order_relaxed);
+    }
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline auto bcpp::implementation::work_contract_group<T>::get_thread_state
+(
+    // latency instrumentation, statistics and tracing only.  the calling thread's state
+    // for this group.  created the first time the thread uses the group.
+) -> thread_state &
+{
+    // each thread caches its state for every group it uses so that threads which
+    // alternate between groups never take threadStateMutex_ after their first use
+    if (threadStateSlot_ < tls_threadStates_.size()) [[likely]]
+        if (auto const & entry = tls_threadStates_[threadStateSlot_]; entry.owner_ == instanceId_) [[likely]]
+            return *entry.threadState_;
+    return register_thread_state();
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline void bcpp::implementation::work_contract_group<T>::record_schedule_latency
+(
+    std::uint64_t ticks
+)
+{
+    if constexpr (latency_instrumentation_enabled)
+        get_thread_state().latency_.record(ticks);
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline void bcpp::implementation::work_contract_group<T>::increment_statistic
+(
+    // statistics only
+    statistics_counter counter,
+    std::uint64_t value
+) noexcept
+{
+    if constexpr (statistics_enabled)
+        get_thread_state().statistics_.increment(counter, value);
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline std::uint64_t bcpp::implementation::work_contract_group<T>::count_select
+(
+    // statistics only.  count one search of a band which visited the specified number of 
+    // subtrees along with its signal tree retries.  returns the search's result.
+    std::uint64_t result,
+    std::uint64_t subTreesScanned,
+    [[maybe_unused]] std::uint64_t selectRetries
+) noexcept
+{
+    if constexpr (statistics_enabled)
+    {
+        auto & statistics = get_thread_state().statistics_;
+        statistics.increment(statistics_counter::selects);
+        statistics.increment(statistics_counter::subtrees_scanned, subTreesScanned);
+        if (selectRetries != 0)
+            statistics.increment(statistics_counter::select_retries, selectRetries);
+    }
+    return result;
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline std::uint64_t bcpp::implementation::work_contract_group<T>::count_poll
+(
+    // statistics only.  count an execute call which found nothing to execute.  returns signalIndex.
+    std::uint64_t signalIndex
+) noexcept
+{
+    if constexpr (statistics_enabled)
+        if (signalIndex == ~0ull)
+            increment_statistic(statistics_counter::empty_polls);
+    return signalIndex;
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+inline void bcpp::implementation::work_contract_group<T>::trace
+(
+    // tracing only
+    trace_event_type type,
+    work_contract_id contractId
+) noexcept
+{
+    if constexpr (tracing_enabled)
+        get_thread_state().trace_.record(type, contractId);
+}
@@ -6,6 +6,11 @@
 namespace bcpp::implementation
 {
 
+    // bits [0, 32)  index of the contract within its priority band
+    // bits [32, 38) priority band
+    // bits [38, 64) generation of the contract's slot when the contract was created.
+    //               a stale id (the slot has since been erased) is rejected because
+    //               its generation no longer matches that of the slot.
     using work_contract_id = std::uint64_t;
     
 } // namespace bcpp::implementation
\ No newline at end of file
@@ -0,0 +1,153 @@
+#include "./worker_pool.h"
+
+#include <string>
+
+#include <pthread.h>
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+bcpp::implementation::worker_pool<T>::worker_pool
+(
+    // the pool is bound to the group but does not start workers until start()
+    work_contract_group_type & workContractGroup,
+    worker_pool_configuration configuration
+):
+    workContractGroup_(workContractGroup),
+    configuration_(configuration),
+    cpus_(cpu_topology().cpus(configuration.useSmtSiblings_))
+{
+    if (configuration_.workerCount_ == 0)
+        configuration_.workerCount_ = cpus_.size();
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+bcpp::implementation::worker_pool<T>::~worker_pool
+(
+)
+{
+    stop();
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+void bcpp::implementation::worker_pool<T>::start
+(
+    // start the configured number of workers (if not already started)
+)
+{
+    std::lock_guard lockGuard(mutex_);
+    while (workers_.size() < configuration_.workerCount_)
+        start_worker(workers_.size());
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+void bcpp::implementation::worker_pool<T>::stop
+(
+    // stop and join every worker.  contracts remain with the group and the
+    // pool can be started again.
+)
+{
+    std::lock_guard lockGuard(mutex_);
+    for (auto & worker : workers_)
+        worker.request_stop();
+    workers_.clear();
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+void bcpp::implementation::worker_pool<T>::resize
+(
+    // change the number of workers.  additional workers are started immediately.
+    // surplus workers (the most recently started) are stopped and joined once they
+    // finish the contract they are executing.
+    std::size_t workerCount
+)
+{
+    std::lock_guard lockGuard(mutex_);
+    configuration_.workerCount_ = workerCount;
+    for (auto i = workerCount; i < workers_.size(); ++i)
+        workers_[i].request_stop();
+    while (workers_.size() > workerCount)
+        workers_.pop_back();
+    while (workers_.size() < workerCount)
+        start_worker(workers_.size());
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+std::size_t bcpp::implementation::worker_pool<T>::size
+(
+) const
+{
+    std::lock_guard lockGuard(mutex_);
+    return workers_.size();
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+std::vector<std::uint32_t> const & bcpp::implementation::worker_pool<T>::cpus
+(
+    // the cpus to which workers are assigned (in order of worker index)
+) const
+{
+    return cpus_;
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+void bcpp::implementation::worker_pool<T>::start_worker
+(
+    std::size_t workerIndex
+)
+{
+    workers_.emplace_back([this, workerIndex](std::stop_token stopToken){run_worker(stopToken, workerIndex);});
+}
+
+
+//=============================================================================
+template <bcpp::synchronization_mode T>
+void bcpp::implementation::worker_pool<T>::run_worker
+(
+    std::stop_token stopToken,
+    std::size_t workerIndex
+)
+{
+    auto cpu = cpus_[workerIndex % cpus_.size()];
+    if (configuration_.pinWorkers_)
+    {
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        CPU_SET(cpu, &cpuSet);
+        pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+    }
+    pthread_setname_np(pthread_self(), ("wc_worker_" + std::to_string(workerIndex)).substr(0, 15).c_str());
+
+    // a distinct (and well spread) starting bias per worker so that workers begin
+    // their selection in different regions of the signal trees
+    std::uint64_t biasFlags = ((workerIndex + 1) * 0x9e3779b97f4a7c15ull);
+    while (!stopToken.stop_requested())
+    {
+        if constexpr (mode == synchronization_mode::blocking)
+            workContractGroup_.execute_next_contract(stop_poll_interval, biasFlags);
+        else
+            workContractGroup_.execute_next_contract(biasFlags);
+    }
+}
+
+
+//=============================================================================
+namespace bcpp::implementation
+{
+    template class worker_pool<synchronization_mode::blocking>;
+    template class worker_pool<synchronization_mode::non_blocking>;
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "./work_contract_group.h"
+#include "./cpu_topology.h"
+
+#include <include/synchronization_mode.h>
+#include <include/non_movable.h>
+#include <include/non_copyable.h>
+
+#include <cstdint>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace bcpp
+{
+
+    struct worker_pool_configuration
+    {
+        // zero: one worker per physical core available to the process
+        std::size_t     workerCount_{0};
+        // place workers on smt siblings only after every physical core has a worker
+        bool            useSmtSiblings_{false};
+        bool            pinWorkers_{true};
+    };
+
+} // namespace bcpp
+
+
+namespace bcpp::implementation
+{
+
+    //=========================================================================
+    // owns the threads which execute the contracts of a work_contract_group.
+    // worker n is pinned to the nth cpu of the process' cpu topology (one per physical
+    // core unless smt siblings are requested) and begins selecting with a bias which
+    // is distinct from that of every other worker.
+    template <synchronization_mode T>
+    class worker_pool :
+        non_copyable,
+        non_movable
+    {
+    public:
+
+        static auto constexpr mode = T;
+        using work_contract_group_type = work_contract_group<mode>;
+
+        worker_pool
+        (
+            work_contract_group_type &,
+            worker_pool_configuration = {}
+        );
+
+        ~worker_pool();
+
+        void start();
+
+        void stop();
+
+        void resize
+        (
+            std::size_t
+        );
+
+        std::size_t size() const;
+
+        std::vector<std::uint32_t> const & cpus() const;
+
+    private:
+
+        // in blocking mode workers wait with this timeout so that they observe stop requests
+        static auto constexpr stop_poll_interval = std::chrono::milliseconds(10);
+
+        void start_worker
+        (
+            std::size_t
+        );
+
+        void run_worker
+        (
+            std::stop_token,
+            std::size_t
+        );
+
+        work_contract_group_type &      workContractGroup_;
+
+        worker_pool_configuration       configuration_;
+
+        std::vector<std::uint32_t>      cpus_;
+
+        std::mutex mutable              mutex_;
+
+        std::vector<std::jthread>       workers_;
+
+    }; // class worker_pool
+
+} // namespace bcpp::implementation
+
+
+namespace bcpp
+{
+    //=========================================================================
+    using blocking_worker_pool = implementation::worker_pool<synchronization_mode::blocking>;
+    using worker_pool = implementation::worker_pool<synchronization_mode::non_blocking>;
+
+} // namespace bcpp
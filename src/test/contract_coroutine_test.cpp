@@ -0,0 +1,65 @@
+#include <library/work_contract.h>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+
+namespace
+{
+
+    //=========================================================================
+    bcpp::contract_coroutine<int> bind_to_group
+    (
+        // record whether co_await group.schedule() bound the coroutine to the group
+        // and which thread it then continued on
+        bcpp::work_contract_group & group,
+        bool & scheduled,
+        std::thread::id & resumedOn
+    )
+    {
+        scheduled = co_await group.schedule();
+        resumedOn = std::this_thread::get_id();
+        co_return 1;
+    }
+
+} // namespace
+
+
+//=============================================================================
+TEST(contract_coroutine, resumes_as_a_contract_of_the_group)
+{
+    bcpp::work_contract_group group(64);
+    auto scheduled = false;
+    std::thread::id resumedOn;
+    auto coroutine = bind_to_group(group, scheduled, resumedOn);
+    EXPECT_FALSE(coroutine.is_done());
+    std::jthread worker([&](){group.execute_next_contract();});
+    worker.join();
+    ASSERT_TRUE(coroutine.is_done());
+    EXPECT_EQ(coroutine.get(), 1);
+    EXPECT_TRUE(scheduled);
+    EXPECT_NE(resumedOn, std::this_thread::get_id());
+}
+
+
+//=============================================================================
+TEST(contract_coroutine, resumes_inline_when_the_group_can_not_create_a_contract)
+{
+    // a stopped group can not grow so once it is full no contract can be created
+    bcpp::work_contract_group group(64);
+    group.stop();
+    std::vector<bcpp::work_contract> contracts;
+    for (auto contract = group.create_contract([](){}); contract.is_valid(); contract = group.create_contract([](){}))
+        contracts.push_back(std::move(contract));
+
+    auto scheduled = true;
+    std::thread::id resumedOn;
+    auto coroutine = bind_to_group(group, scheduled, resumedOn);
+    EXPECT_TRUE(coroutine.is_done());
+    EXPECT_FALSE(scheduled);
+    EXPECT_EQ(resumedOn, std::this_thread::get_id());
+    // nothing (in particular, no stale contract id) was scheduled
+    EXPECT_EQ(group.execute_next_contract(), ~0ull);
+}
@@ -0,0 +1,130 @@
+#include <library/work_contract.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+
+namespace
+{
+
+    //=========================================================================
+    template <typename G>
+    std::vector<std::jthread> start_workers
+    (
+        G & group,
+        std::uint64_t workerCount
+    )
+    {
+        std::vector<std::jthread> workers;
+        for (auto i = 0ull; i < workerCount; ++i)
+            workers.emplace_back([&](std::stop_token stopToken)
+                    {
+                        while (!stopToken.stop_requested())
+                        {
+                            if constexpr (G::mode == bcpp::synchronization_mode::blocking)
+                                group.execute_next_contract(std::chrono::milliseconds(1));
+                            else
+                                group.execute_next_contract();
+                        }
+                    });
+        return workers;
+    }
+
+} // namespace
+
+
+//=============================================================================
+TEST(contract_graph, runs_nodes_after_their_predecessors)
+{
+    // 0 -> {1, 2} -> 3
+    bcpp::work_contract_group group(64);
+    bcpp::contract_graph graph(group);
+    std::atomic<std::uint32_t> order = 0;
+    std::vector<std::uint32_t> position(4);
+    for (auto i = 0u; i < 4; ++i)
+        graph.add_node([&, i](){position[i] = order++;});
+    graph.add_edge(0, 1);
+    graph.add_edge(0, 2);
+    graph.add_edge(1, 3);
+    graph.add_edge(2, 3);
+
+    auto workers = start_workers(group, 2);
+    for (auto run = 0; run < 100; ++run)
+    {
+        order = 0;
+        ASSERT_TRUE(graph.run());
+        graph.wait();
+        EXPECT_TRUE(graph.is_complete());
+        EXPECT_EQ(order, 4u);
+        EXPECT_EQ(position[0], 0u);
+        EXPECT_LT(position[1], position[3]);
+        EXPECT_LT(position[2], position[3]);
+    }
+}
+
+
+//=============================================================================
+TEST(contract_graph, rejects_cycles)
+{
+    bcpp::work_contract_group group(64);
+    bcpp::contract_graph graph(group);
+    graph.add_node([](){});
+    graph.add_node([](){});
+    graph.add_edge(0, 1);
+    graph.add_edge(1, 0);
+    EXPECT_FALSE(graph.run());
+    EXPECT_TRUE(graph.is_complete());
+}
+
+
+//=============================================================================
+TEST(contract_graph, node_which_throws_is_complete)
+{
+    bcpp::work_contract_group group(64);
+    bcpp::contract_graph graph(group);
+    std::atomic<bool> sinkExecuted = false;
+    graph.add_node([](){throw std::runtime_error("node failed");});
+    graph.add_node([&](){sinkExecuted = true;});
+    graph.add_edge(0, 1);
+
+    auto workers = start_workers(group, 1);
+    ASSERT_TRUE(graph.run());
+    graph.wait();
+    EXPECT_TRUE(sinkExecuted);
+}
+
+
+//=============================================================================
+TEST(contract_graph, run_wait_destroy)
+{
+    // the graph is destroyed as soon as wait() returns.  the last sink must not
+    // touch the graph after that (a use after free which a sanitizer reports).
+    // blocking workers so that the check is also quick on a single cpu.
+    static auto constexpr width = 8u;
+    bcpp::blocking_work_contract_group group(64);
+    auto workers = start_workers(group, std::max(2u, std::thread::hardware_concurrency()));
+    for (auto run = 0; run < 10000; ++run)
+    {
+        std::atomic<std::uint32_t> executions = 0;
+        auto graph = std::make_unique<bcpp::blocking_contract_graph>(group);
+        for (auto i = 0u; i < (width + 2); ++i)
+            graph->add_node([&](){++executions;});
+        for (auto i = 1u; i <= width; ++i)
+        {
+            graph->add_edge(0, i);
+            graph->add_edge(i, width + 1);
+        }
+        ASSERT_TRUE(graph->run());
+        graph->wait();
+        graph.reset();
+        ASSERT_EQ(executions, width + 2);
+    }
+}
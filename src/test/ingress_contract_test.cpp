@@ -0,0 +1,141 @@
+#include <library/work_contract.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <span>
+#include <thread>
+#include <vector>
+
+
+namespace
+{
+
+    //=========================================================================
+    template <typename G>
+    std::uint64_t schedule_calls
+    (
+        // statistics builds only (-DWORK_CONTRACT_STATISTICS=ON)
+        G const & group
+    )
+    {
+        if constexpr (bcpp::implementation::statistics_enabled)
+            return group.get_statistics().scheduleCalls_;
+        else
+            return 0;
+    }
+
+} // namespace
+
+
+//=============================================================================
+TEST(ingress_contract, first_push_schedules_the_contract)
+{
+    bcpp::work_contract_group group(64);
+    std::vector<int> received;
+    auto executions = 0;
+    bcpp::ingress_contract<int> ingress(group, {.capacity_ = 16, .maxBatchSize_ = 16},
+            [&](std::span<int> values)
+            {
+                ++executions;
+                received.insert(received.end(), values.begin(), values.end());
+            });
+
+    // nothing is scheduled until the ring goes from empty to non empty
+    EXPECT_EQ(group.execute_next_contract(), ~0ull);
+    for (auto i = 0; i < 10; ++i)
+        ASSERT_TRUE(ingress.try_push(i));
+    if constexpr (bcpp::implementation::statistics_enabled)
+    {
+        EXPECT_EQ(schedule_calls(group), 1ull);
+    }
+
+    // one execution drains every item and nothing remains scheduled
+    EXPECT_NE(group.execute_next_contract(), ~0ull);
+    EXPECT_EQ(group.execute_next_contract(), ~0ull);
+    EXPECT_EQ(executions, 1);
+    EXPECT_EQ(received, (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+
+    // once drained, the next push schedules the contract again
+    ASSERT_TRUE(ingress.try_push(10));
+    EXPECT_NE(group.execute_next_contract(), ~0ull);
+    EXPECT_EQ(executions, 2);
+    EXPECT_EQ(received.back(), 10);
+}
+
+
+//=============================================================================
+TEST(ingress_contract, reschedules_while_items_remain)
+{
+    bcpp::work_contract_group group(64);
+    std::vector<std::size_t> batchSizes;
+    bcpp::ingress_contract<int> ingress(group, {.capacity_ = 16, .maxBatchSize_ = 4},
+            [&](std::span<int> values){batchSizes.push_back(values.size());});
+
+    for (auto i = 0; i < 10; ++i)
+        ASSERT_TRUE(ingress.try_push(i));
+    while (group.execute_next_contract() != ~0ull)
+        ;
+    EXPECT_EQ(batchSizes, (std::vector<std::size_t>{4, 4, 2}));
+}
+
+
+//=============================================================================
+TEST(ingress_contract, full_ring_rejects_push)
+{
+    bcpp::work_contract_group group(64);
+    bcpp::ingress_contract<int> ingress(group, {.capacity_ = 4, .maxBatchSize_ = 4}, [](std::span<int>){});
+    for (auto i = 0; i < 4; ++i)
+        ASSERT_TRUE(ingress.try_push(i));
+    EXPECT_FALSE(ingress.try_push(4));
+    while (group.execute_next_contract() != ~0ull)
+        ;
+    EXPECT_TRUE(ingress.try_push(4));
+}
+
+
+//=============================================================================
+TEST(ingress_contract, multiple_producers_deliver_every_item_in_order)
+{
+    static auto constexpr producer_count = 4;
+    static auto constexpr items_per_producer = 20000;
+    bcpp::work_contract_group group(64);
+    std::vector<int> next(producer_count, 0);
+    std::atomic<int> received = 0;
+    std::atomic<bool> inOrder = true;
+    bcpp::ingress_contract<int, bcpp::producer_model::multiple> ingress(group, {.capacity_ = 256, .maxBatchSize_ = 32},
+            [&](std::span<int> values)
+            {
+                // each item is (producer * items_per_producer) + sequence
+                for (auto value : values)
+                {
+                    auto producer = (value / items_per_producer);
+                    if ((value % items_per_producer) != next[producer]++)
+                        inOrder = false;
+                }
+                received += values.size();
+            });
+
+    {
+        std::jthread consumer([&](std::stop_token stopToken)
+                {
+                    while (!stopToken.stop_requested())
+                        group.execute_next_contract();
+                });
+        std::vector<std::jthread> producers;
+        for (auto producer = 0; producer < producer_count; ++producer)
+            producers.emplace_back([&, producer]()
+                    {
+                        for (auto i = 0; i < items_per_producer; ++i)
+                            while (!ingress.try_push((producer * items_per_producer) + i))
+                                std::this_thread::yield();
+                    });
+        for (auto & thread : producers)
+            thread.join();
+        while (received < (producer_count * items_per_producer))
+            std::this_thread::yield();
+    }
+    EXPECT_EQ(received, producer_count * items_per_producer);
+    EXPECT_TRUE(inOrder);
+}
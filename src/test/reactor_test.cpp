@@ -0,0 +1,162 @@
+#include <library/work_contract.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+
+namespace
+{
+
+    using namespace std::chrono_literals;
+
+    //=========================================================================
+    template <typename P>
+    bool wait_until
+    (
+        // returns false if the predicate is still false after the timeout
+        P predicate,
+        std::chrono::milliseconds timeout = 5s
+    )
+    {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (!predicate())
+        {
+            if (std::chrono::steady_clock::now() > deadline)
+                return false;
+            std::this_thread::sleep_for(100us);
+        }
+        return true;
+    }
+
+
+    //=========================================================================
+    // each test runs once with each backend.  io_uring falls back to epoll where
+    // it is not available.
+    class reactor_test :
+        public ::testing::TestWithParam<bcpp::reactor::backend>
+    {
+    protected:
+
+        void SetUp() override
+        {
+            worker_ = std::jthread([this](std::stop_token stopToken)
+                    {
+                        while (!stopToken.stop_requested())
+                            group_.execute_next_contract(1ms);
+                    });
+        }
+
+        void TearDown() override
+        {
+            stop_worker();
+        }
+
+        // join the worker so that no contract is still using a descriptor which the test closes
+        void stop_worker()
+        {
+            if (worker_.joinable())
+            {
+                worker_.request_stop();
+                worker_.join();
+            }
+        }
+
+        bcpp::blocking_work_contract_group  group_{64};
+        std::jthread                        worker_;
+    };
+
+} // namespace
+
+
+//=============================================================================
+TEST_P(reactor_test, pipe_readiness_schedules_the_contract)
+{
+    int pipeFds[2];
+    ASSERT_EQ(::pipe2(pipeFds, O_NONBLOCK), 0);
+    std::atomic<int> executions = 0;
+    std::atomic<int> bytes = 0;
+    auto contract = group_.create_contract([&]()
+            {
+                ++executions;
+                char buffer[64];
+                for (auto n = ::read(pipeFds[0], buffer, sizeof(buffer)); n > 0; n = ::read(pipeFds[0], buffer, sizeof(buffer)))
+                    bytes += n;
+            });
+    {
+        bcpp::reactor reactor(GetParam());
+        ASSERT_TRUE(reactor.add(pipeFds[0], contract));
+        EXPECT_FALSE(reactor.add(pipeFds[0], contract));
+
+        ASSERT_EQ(::write(pipeFds[1], "abc", 3), 3);
+        EXPECT_TRUE(wait_until([&](){return (bytes == 3);}));
+
+        // readiness is edge triggered.  a drained descriptor does not fire again.
+        std::this_thread::sleep_for(20ms);
+        auto executionsAfterDrain = executions.load();
+        std::this_thread::sleep_for(20ms);
+        EXPECT_EQ(executions, executionsAfterDrain);
+
+        // new data fires again
+        ASSERT_EQ(::write(pipeFds[1], "de", 2), 2);
+        EXPECT_TRUE(wait_until([&](){return (bytes == 5);}));
+
+        // once removed, readiness no longer schedules the contract
+        EXPECT_TRUE(reactor.remove(pipeFds[0]));
+        std::this_thread::sleep_for(20ms);
+        auto executionsAfterRemove = executions.load();
+        ASSERT_EQ(::write(pipeFds[1], "f", 1), 1);
+        std::this_thread::sleep_for(20ms);
+        EXPECT_EQ(executions, executionsAfterRemove);
+        reactor.stop();
+    }
+    stop_worker();
+    ::close(pipeFds[0]);
+    ::close(pipeFds[1]);
+}
+
+
+//=============================================================================
+TEST_P(reactor_test, eventfd_signals_are_all_consumed)
+{
+    static auto constexpr signal_count = 1000;
+    int eventFd = ::eventfd(0, EFD_NONBLOCK);
+    ASSERT_GE(eventFd, 0);
+    std::atomic<int> executions = 0;
+    std::atomic<std::uint64_t> signals = 0;
+    auto contract = group_.create_contract([&]()
+            {
+                ++executions;
+                if (std::uint64_t count; ::read(eventFd, &count, sizeof(count)) == sizeof(count))
+                    signals += count;
+            });
+    {
+        bcpp::reactor reactor(GetParam());
+        ASSERT_TRUE(reactor.add(eventFd, contract));
+        for (auto i = 0; i < signal_count; ++i)
+        {
+            std::uint64_t one = 1;
+            ASSERT_EQ(::write(eventFd, &one, sizeof(one)), static_cast<ssize_t>(sizeof(one)));
+        }
+        EXPECT_TRUE(wait_until([&](){return (signals == signal_count);}));
+        // signals which arrive while the contract is scheduled coalesce
+        EXPECT_LE(executions, signal_count);
+        reactor.remove(eventFd);
+        reactor.stop();
+    }
+    stop_worker();
+    ::close(eventFd);
+}
+
+
+//=============================================================================
+INSTANTIATE_TEST_SUITE_P(backends, reactor_test,
+        ::testing::Values(bcpp::reactor::backend::epoll, bcpp::reactor::backend::io_uring),
+        [](auto const & info){return (info.param == bcpp::reactor::backend::epoll) ? "epoll" : "io_uring";});
@@ -0,0 +1,166 @@
+#include <library/work_contract.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <set>
+#include <span>
+#include <thread>
+#include <vector>
+
+
+namespace
+{
+
+    // the layout of a contract id (see work_contract_id.h)
+    static auto constexpr contract_index_mask = ((1ull << 32) - 1);
+    static auto constexpr band_shift = 32;
+    static auto constexpr band_mask = 0x3full;
+
+
+    //=========================================================================
+    template <typename G>
+    void execute_all
+    (
+        // execute contracts until none remain scheduled
+        G & group
+    )
+    {
+        while (group.execute_next_contract() != ~0ull)
+            ;
+    }
+
+} // namespace
+
+
+//=============================================================================
+TEST(work_contract_group, release_invalidates_contract_id)
+{
+    bcpp::work_contract_group group(64);
+    auto contract = group.create_contract([](){});
+    auto staleId = contract.get_id();
+    EXPECT_TRUE(group.is_valid(staleId));
+
+    EXPECT_TRUE(contract.release());
+    execute_all(group);
+    EXPECT_FALSE(contract.is_valid());
+    EXPECT_FALSE(group.is_valid(staleId));
+    EXPECT_FALSE(group.release(staleId));
+
+    // fill the group so that the released slot is reused.  the stale id must
+    // neither schedule nor release the contract now occupying that slot.
+    std::atomic<std::uint64_t> executions = 0;
+    std::vector<bcpp::work_contract> contracts;
+    for (auto i = 0; i < 64; ++i)
+        contracts.push_back(group.create_contract([&](){++executions;}));
+    auto reused = std::find_if(contracts.begin(), contracts.end(), [&](auto const & c){return ((c.get_id() & contract_index_mask) == (staleId & contract_index_mask));});
+    ASSERT_NE(reused, contracts.end());
+    EXPECT_NE(reused->get_id(), staleId);
+    EXPECT_FALSE(group.schedule(staleId));
+    EXPECT_FALSE(group.release(staleId));
+    execute_all(group);
+    EXPECT_EQ(executions, 0);
+    EXPECT_TRUE(reused->is_valid());
+}
+
+
+//=============================================================================
+TEST(work_contract_group, stop_invalidates_contracts)
+{
+    bcpp::work_contract_group group(64);
+    auto contract = group.create_contract([](){});
+    EXPECT_TRUE(contract.is_valid());
+    group.stop();
+    EXPECT_FALSE(contract.is_valid());
+    EXPECT_FALSE(contract.release());
+}
+
+
+//=============================================================================
+TEST(work_contract_group, growth_keeps_contract_ids_within_their_band)
+{
+    // grow band 1 of a two band group from a single subtree (64 contracts) to 64k contracts
+    static auto constexpr contract_count = (1ull << 16);
+    bcpp::work_contract_group group(64, 2);
+    auto initialCapacity = group.capacity();
+
+    std::atomic<std::uint64_t> executions = 0;
+    std::vector<bcpp::work_contract> contracts;
+    contracts.reserve(contract_count);
+    std::set<std::uint64_t> indices;
+    for (auto i = 0ull; i < contract_count; ++i)
+    {
+        contracts.push_back(group.create_contract(bcpp::priority_band{1}, [&](){++executions;}));
+        ASSERT_TRUE(contracts.back().is_valid());
+        auto id = contracts.back().get_id();
+        EXPECT_EQ(((id >> band_shift) & band_mask), 1ull);
+        EXPECT_TRUE(indices.insert(id & contract_index_mask).second);
+    }
+    EXPECT_GT(group.capacity(), initialCapacity);
+
+    group.schedule(std::span<bcpp::work_contract>(contracts));
+    execute_all(group);
+    EXPECT_EQ(executions, contract_count);
+}
+
+
+//=============================================================================
+TEST(work_contract_group, empty_band_weights_is_a_single_band)
+{
+    bcpp::work_contract_group group(64, std::vector<std::uint64_t>{});
+    EXPECT_EQ(group.band_count(), 1ull);
+    auto executions = 0;
+    auto contract = group.create_contract([&](){++executions;});
+    contract.schedule();
+    execute_all(group);
+    EXPECT_EQ(executions, 1);
+}
+
+
+//=============================================================================
+TEST(work_contract_group, blocking_workers_are_woken_for_remaining_contracts)
+{
+    // the contracts share one subtree so scheduling them wakes a single parked worker.
+    // each contract waits for all of them to be executing at once, which requires
+    // that the woken worker wakes another while contracts remain.
+    static auto constexpr worker_count = 4;
+    bcpp::blocking_work_contract_group group(64);
+    std::atomic<int> executing = 0;
+    std::atomic<int> concurrent = 0;
+    std::atomic<int> finished = 0;
+    std::vector<bcpp::blocking_work_contract> contracts;
+    for (auto i = 0; i < worker_count; ++i)
+        contracts.push_back(group.create_contract([&]()
+                {
+                    ++executing;
+                    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+                    while ((executing < worker_count) && (std::chrono::steady_clock::now() < deadline))
+                        std::this_thread::yield();
+                    concurrent += (executing == worker_count);
+                    ++finished;
+                }));
+
+    std::vector<std::jthread> workers;
+    for (auto i = 0; i < worker_count; ++i)
+        workers.emplace_back([&](std::stop_token stopToken)
+                {
+                    // untimed waits so that a worker runs only if it is woken
+                    while (!stopToken.stop_requested())
+                        group.execute_next_contract();
+                });
+    // let the workers park
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    group.schedule(std::span<bcpp::blocking_work_contract>(contracts));
+
+    while (finished < worker_count)
+        std::this_thread::yield();
+    for (auto & worker : workers)
+        worker.request_stop();
+    group.stop();
+    for (auto & worker : workers)
+        worker.join();
+    EXPECT_EQ(concurrent, worker_count);
+}